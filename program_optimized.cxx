@@ -8,32 +8,165 @@
 #include <iomanip>
 #include <sstream>
 #include <locale>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <cerrno>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <cstring>
+#include <cmath>
+#include <cctype>
+#include <new>
+#include <map>
+#include <tuple>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <mutex>
+#include <condition_variable>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <linux/perf_event.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <poll.h>
+#include <csignal>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#include <cpuid.h>
+#define STRESS_X86 1
+#endif
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
 
 // For convenience
 namespace fs = std::filesystem;
-using n_type = uint_fast32_t;
+// Counters are 64-bit on every ABI: uint_fast32_t is only 32 bits on some, and a
+// tight loop can wrap that within a few cycles.
+using n_type = std::uint64_t;
 
-// Optional: speed up iostream by decoupling from C stdio
-/*
+// Run totals across cycles (and threads) go through a 128-bit accumulator where the
+// compiler has one.
+#if defined(__SIZEOF_INT128__)
+using sum_type = unsigned __int128;
+#else
+using sum_type = std::uint64_t;
+#endif
+
+// Speed up iostream by decoupling from C stdio. Only the console thread writes
+// std::cout, so std::cerr is untied too: flushing it must not touch std::cout
 static struct IOSyncOff {
     IOSyncOff() {
         std::ios_base::sync_with_stdio(false);
         std::cin.tie(nullptr);
+        std::cerr.tie(nullptr);
     }
 } iosyncoff_instance;
-*/
+
+/**
+ * The user's locale, built once: constructing std::locale("") reads the locale
+ * database every time. Falls back to the classic locale when LANG names a locale
+ * that is not installed.
+ */
+static const std::locale &userLocale()
+{
+    static const std::locale locale = []()
+    {
+        try
+        {
+            return std::locale("");
+        }
+        catch(const std::runtime_error &)
+        {
+            return std::locale::classic();
+        }
+    }();
+
+    return locale;
+}
 
 static const std::string formatWithCommas(const n_type &value)
 {
     std::stringstream ss;
 
-    ss.imbue(std::locale(""));
+    ss.imbue(userLocale());
 
     ss << value;
 
     return ss.str();
 }
 
+/**
+ * Plain decimal text for a run total (iostreams cannot print 128-bit integers).
+ */
+static std::string sumToString(sum_type value)
+{
+    char digits[48];
+    int n = 0;
+
+    do
+    {
+        digits[n++] = static_cast<char>('0' + static_cast<int>(value % 10u));
+        value /= 10u;
+    }
+    while(value != 0u);
+
+    return std::string(std::make_reverse_iterator(digits + n), std::make_reverse_iterator(digits));
+}
+
+/**
+ * formatWithCommas for a run total, grouping by the user's locale like the n_type version.
+ */
+static std::string formatWithCommas(const sum_type &value)
+{
+    if(value <= std::numeric_limits<n_type>::max()) return formatWithCommas(static_cast<n_type>(value));
+
+    const std::string digits = sumToString(value);
+    const auto &punct = std::use_facet<std::numpunct<char>>(userLocale());
+    const std::string grouping = punct.grouping();
+
+    if(grouping.empty() || grouping[0] <= 0) return digits;
+
+    std::string out;
+    std::size_t g = 0u;
+    int inGroup = 0;
+
+    for(std::size_t k = digits.size(); k-- > 0u;)
+    {
+        if(inGroup == grouping[g])
+        {
+            out += punct.thousands_sep();
+            inGroup = 0;
+            if(g + 1u < grouping.size() && grouping[g + 1u] > 0) ++g;
+        }
+
+        out += digits[k];
+        ++inGroup;
+    }
+
+    return std::string(out.rbegin(), out.rend());
+}
+
 /**
  * Return a string representing local date/time in a default style,
  * e.g. "2025-03-16 07:14:02".
@@ -73,222 +206,8553 @@ static const std::string getFileTimestamp()
     return std::string(buf);
 }
 
-int main()
+/**
+ * Raw monotonic clock in nanoseconds. Not slewed by NTP and served from the vDSO,
+ * so it is the cheapest trustworthy clock for deadline checks.
+ */
+static inline std::uint64_t monotonicRawNs()
 {
-    // 1) Build directory paths
-    fs::path currentDir = fs::current_path();
-    fs::path logDetailDir = currentDir / "CycleLogDetail";
-    fs::path iterationDir = currentDir / "CycleLog";
+    timespec ts;
 
-    // 2) Create directories if needed
-    fs::create_directories(logDetailDir);
-    fs::create_directories(iterationDir);
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
 
-    // 3) Verify existence
-    if(!fs::exists(logDetailDir) || !fs::exists(iterationDir))
-    {
-        std::cerr << "Directories do not exist\nMissing:\n";
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(ts.tv_nsec);
+}
 
-        if(!fs::exists(logDetailDir))  std::cerr << logDetailDir << "\n";
-        if(!fs::exists(iterationDir))  std::cerr << iterationDir << "\n";
+/**
+ * Wall-clock time straight from clock_gettime, without the localtime_r breakdown.
+ * The local second rolls over exactly when tv_sec does.
+ */
+static inline timespec wallClockNow()
+{
+    timespec ts;
 
-        return 1;
-    }
+    clock_gettime(CLOCK_REALTIME, &ts);
 
-    fs::path iterationLogPath = iterationDir / "Iteration.txt";
+    return ts;
+}
 
-    // 4) Print banner
-    std::cout << std::string(50, '*') << "\n";
-    std::cout << "Gautier Iteration Test\n"
-              << "Provides an informal assessment of operations per second on a given system\n"
-              << "Essentially how fast can C++ code execute today\n"
-              << "Helps in building better estimates for capacity planning and design\n"
-              << std::string(50, '*') << "\n"
-              << "How many times you want the test to run?\n"
-              << "Type number then <enter>:  ";
-
-    // 5) Get user input
-    n_type cycles = 1u;
+/**
+ * Raw time-stamp counter (TSC on x86, the virtual counter on AArch64); 0 elsewhere.
+ */
+static inline std::uint64_t readTsc()
+{
+#if defined(STRESS_X86)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return 0u;
+#endif
+}
+
+static bool tscSupported()
+{
+#if defined(STRESS_X86) || defined(__aarch64__)
+    return true;
+#else
+    return false;
+#endif
+}
 
-    std::cin >> cycles;
+/**
+ * Time-stamp counter mapped onto CLOCK_MONOTONIC_RAW. Only 'usable' when the counter
+ * is invariant (constant rate, keeps ticking in C-states) and calibrated cleanly;
+ * otherwise 'reason' says why and callers stay on the steady clock.
+ */
+struct TscClock
+{
+    bool usable = false;
+    bool hasRdtscp = false;
+    double ticksPerNs = 1.0;
+    std::uint64_t baseTicks = 0u;
+    std::uint64_t baseNs = 0u;
+    std::string reason;
 
-    if(!std::cin.good() || cycles < 1)
+    /**
+     * Serialized read for window edges: rdtscp where available, else lfence + rdtsc.
+     */
+    std::uint64_t orderedNow() const
     {
-        std::cerr << "Invalid input; defaulting to 1.\n";
-        cycles = 1u;
-    }
+#if defined(STRESS_X86)
+        if(hasRdtscp)
+        {
+            unsigned aux;
+            return __rdtscp(&aux);
+        }
 
-    std::cout << "Running " << cycles << " test runs\n";
+        _mm_lfence();
+        const std::uint64_t ticks = __rdtsc();
+        _mm_lfence();
+        return ticks;
+#elif defined(__aarch64__)
+        asm volatile("isb" ::: "memory");
+        return readTsc();
+#else
+        return 0u;
+#endif
+    }
 
-    // Append initial info to iteration log
+    std::uint64_t toTicks(const std::uint64_t rawNs) const
     {
-        std::ofstream itLog(iterationLogPath, std::ios::app);
-        itLog << std::string(33, '*') << "\n";
-        itLog << "Cycles: " << cycles << "\t"
-              << dateTimeToString(std::chrono::system_clock::now()) << "\n";
-        itLog << std::string(28, '*') << "\n";
+        return baseTicks + static_cast<std::uint64_t>(static_cast<double>(rawNs - baseNs) * ticksPerNs);
     }
 
-    // For final summary
-    n_type sumOfIterations = 0;
-    const auto cycleStartTime = std::chrono::system_clock::now();
-
-    // 6) Loop over cycles
-    for(n_type cycle = 1u; cycle <= cycles; ++cycle)
+    std::uint64_t toNs(const std::uint64_t ticks) const
     {
-        std::cout << std::string(76, '*') << "\n";
-        std::cout << "Running Cycle "
-                  << std::setw(2) << std::setfill('0') << cycle
-                  << " of "
-                  << std::setw(2) << std::setfill('0') << cycles << "\n";
-        std::cout << std::string(44, '*') << "\n";
+        return baseNs + static_cast<std::uint64_t>(static_cast<double>(ticks - baseTicks) / ticksPerNs);
+    }
+};
 
-        // Build detail file name
-        std::ostringstream fname;
+/**
+ * Whether the first "flags" line of /proc/cpuinfo lists 'flag'. 'found' is false
+ * when there is no such line to look at.
+ */
+static bool cpuinfoHasFlag(const std::string &flag, bool &found)
+{
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
 
-        fname << "T " << getFileTimestamp() << " "
-              << std::setw(2) << std::setfill('0') << cycles << " - "
-              << std::setw(2) << std::setfill('0') << cycle << ".txt";
+    found = false;
 
-        fs::path detailFilePath = logDetailDir / fname.str();
+    while(std::getline(cpuinfo, line))
+    {
+        if(line.compare(0, 5, "flags") != 0) continue;
 
-        // We'll collect log lines in a buffer (like StringBuilder in C#)
-        std::ostringstream buffer;
+        found = true;
+        return (line + " ").find(" " + flag + " ") != std::string::npos;
+    }
 
-        // 7) Pause logic if local second % 8 == 0
-        //    (This is also somewhat expensive, so we do it only once at start.)
-        {
-            auto nowSys   = std::chrono::system_clock::now();
-            auto nowTimeT = std::chrono::system_clock::to_time_t(nowSys);
+    return false;
+}
 
-            std::tm localTm{};
+/**
+ * Check that the counter is invariant, then calibrate it against CLOCK_MONOTONIC_RAW
+ * (never slewed by NTP) in five 10 ms rounds. Each pairing of the two clocks takes
+ * the tightest of several bracketed reads, and the rounds must agree within 0.05%.
+ */
+static TscClock calibrateTscClock()
+{
+    TscClock clock;
 
-            localtime_r(&nowTimeT, &localTm);
+    if(!tscSupported())
+    {
+        clock.reason = "no time-stamp counter on this architecture";
+        return clock;
+    }
 
-            while(localTm.tm_sec % 8 == 0)
-            {
-                // Sleep
-                n_type pauseMs = static_cast<n_type>(localTm.tm_sec) * 100u;
-                std::cout << "Pausing for " << pauseMs << "ms\n";
-                buffer << "Paused for " << pauseMs << "ms\n";
-                std::this_thread::sleep_for(std::chrono::milliseconds(pauseMs));
+#if defined(STRESS_X86)
+    bool haveFlags = false;
+    const bool constantTsc = cpuinfoHasFlag("constant_tsc", haveFlags);
+    const bool nonstopTsc  = cpuinfoHasFlag("nonstop_tsc", haveFlags);
+    unsigned eax = 0u, ebx = 0u, ecx = 0u, edx = 0u;
 
-                // Re-check
-                nowSys  = std::chrono::system_clock::now();
-                nowTimeT= std::chrono::system_clock::to_time_t(nowSys);
-                localtime_r(&nowTimeT, &localTm);
-            }
-        }
+    if(__get_cpuid(0x80000001u, &eax, &ebx, &ecx, &edx)) clock.hasRdtscp = (edx >> 27) & 1u;
 
-        const auto nowTp  = std::chrono::system_clock::now();
-        const auto startTp= std::chrono::steady_clock::now();  // Use steady_clock for iteration
-        const auto endTp  = startTp + std::chrono::seconds(1); // We’ll loop for ~1 second
+    if(!haveFlags)
+    {
+        // No /proc/cpuinfo: CPUID's invariant-TSC bit implies both flags
+        const bool invariant = __get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx) && ((edx >> 8) & 1u);
 
-        const std::string nowStr   = dateTimeToString(nowTp);
-        const std::string startStr = dateTimeToString(std::chrono::system_clock::now());
+        if(!invariant)
+        {
+            clock.reason = "CPUID does not report an invariant TSC";
+            return clock;
+        }
+    }
+    else if(!constantTsc || !nonstopTsc)
+    {
+        clock.reason = std::string(constantTsc ? "" : "constant_tsc ") + (nonstopTsc ? "" : "nonstop_tsc ") + "not reported";
+        return clock;
+    }
+#endif
 
-        std::cout << "Ready to go ... " << nowStr << "\n";
+    constexpr int rounds = 5;
+    constexpr std::uint64_t roundNs = 10000000u;
 
-        // 9) Start measuring iteration
-        n_type iterations = 0u;
-        n_type i = 0u;
+    // One clock pairing: the raw-ns midpoint of the narrowest of 16 bracketed counter reads
+    const auto pairClocks = [&clock](std::uint64_t &ticks, std::uint64_t &ns)
+    {
+        std::uint64_t bestWidth = ~std::uint64_t(0);
 
-        // Loop until 1 second has elapsed
-        while(std::chrono::steady_clock::now() < endTp)
+        for(int attempt = 0; attempt < 16; ++attempt)
         {
-            iterations = i + 1u; 
-            ++i;
+            const std::uint64_t before = monotonicRawNs();
+            const std::uint64_t t = clock.orderedNow();
+            const std::uint64_t after  = monotonicRawNs();
 
-            // If i is multiple of 100K, record progress
-            if((i % 100000u) == 0u)
+            if(after - before < bestWidth)
             {
-                auto progressTp = std::chrono::system_clock::now();
-                std::string progTimeStr = dateTimeToString(progressTp);
-                buffer << "Cycle " << formatWithCommas(cycle) << " of " << formatWithCommas(cycles)
-                       << " Iteration " << formatWithCommas(i) << " " << progTimeStr << "\n";
+                bestWidth = after - before;
+                ticks = t;
+                ns = before + (after - before) / 2u;
             }
         }
+    };
 
-        sumOfIterations += iterations;
-
-        const auto realEndSys = std::chrono::system_clock::now();
-        const std::string endStr = dateTimeToString(realEndSys);
+    std::uint64_t firstTicks = 0u, firstNs = 0u;
+    pairClocks(firstTicks, firstNs);
 
-        // 10) Print iteration results to console
-        buffer << "Iterations " << formatWithCommas(iterations)
-               << " Start " << startStr
-               << " ... End " << endStr << "\n";
+    std::uint64_t lastTicks = firstTicks, lastNs = firstNs;
+    double minRate = 0.0, maxRate = 0.0;
 
-        // Show path to detail file
-        std::cout << detailFilePath.string() << "\n";
+    for(int r = 0; r < rounds; ++r)
+    {
+        const std::uint64_t roundTicks = lastTicks, roundStartNs = lastNs;
 
-        // Write buffer to detail file
+        while(monotonicRawNs() - roundStartNs < roundNs)
         {
-            std::ofstream ofs(detailFilePath);
-
-            if(ofs.is_open()) {
-                ofs << buffer.str();
-            }
         }
 
-        std::cout << buffer.str();
+        pairClocks(lastTicks, lastNs);
 
-        // Append info to iteration log
+        if(lastTicks <= roundTicks)
         {
-            std::ofstream itLog(iterationLogPath, std::ios::app);
-            itLog << "***\t" << cycle << "\t" << std::string(60, '*') << "\n";
-            itLog << startStr << "\n";
-            itLog << iterations << "\n";
-            itLog << endStr << "\n\n";
+            clock.reason = "counter did not advance during calibration";
+            return clock;
         }
+
+        const double rate = static_cast<double>(lastTicks - roundTicks) / static_cast<double>(lastNs - roundStartNs);
+
+        minRate = (r == 0) ? rate : std::min(minRate, rate);
+        maxRate = (r == 0) ? rate : std::max(maxRate, rate);
+    }
+
+    clock.ticksPerNs = static_cast<double>(lastTicks - firstTicks) / static_cast<double>(lastNs - firstNs);
+    clock.baseTicks  = lastTicks;
+    clock.baseNs     = lastNs;
+
+    if((maxRate - minRate) / clock.ticksPerNs > 0.0005)
+    {
+        std::ostringstream reason;
+        reason << "rate varied by " << std::fixed << std::setprecision(3)
+               << (maxRate - minRate) / clock.ticksPerNs * 100.0 << "% across calibration rounds";
+        clock.reason = reason.str();
+        return clock;
+    }
+
+    clock.usable = true;
+
+    return clock;
+}
+
+/**
+ * Keep the compiler from folding a run of increments into one add.
+ */
+static inline void keepCounter(n_type &value)
+{
+    asm volatile("" : "+r"(value));
+}
+
+/**
+ * Keep the compiler from discarding or folding a 64-bit accumulator.
+ */
+static inline void keepValue(std::uint64_t &value)
+{
+    asm volatile("" : "+r"(value));
+}
+
+/**
+ * Small, fast PRNG for filling kernel inputs (splitmix64).
+ */
+static inline std::uint64_t nextRandom(std::uint64_t &state)
+{
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Per-worker scratch for a kernel. Prepared on the worker's own thread before the
+ * window opens, so buffers are first-touched on the worker's CPU.
+ */
+struct KernelState
+{
+    n_type counter = 0u;
+    std::uint64_t acc[4] = {1u, 2u, 3u, 4u};
+    double fp[8] = {1.0, 1.5, 2.0, 2.5, 3.0, 3.5, 4.0, 4.5};
+    std::vector<std::uint8_t> bytes;
+    std::vector<std::uint32_t> chain;
+    std::uint32_t crcTable[256] = {};
+    std::size_t cursor = 0u;
+};
+
+/**
+ * Run 'count' operations of a kernel. What one operation is depends on the kernel.
+ */
+using KernelBatchFn = void (*)(KernelState &state, n_type count);
+
+/**
+ * Registry entry for a workload kernel.
+ */
+struct KernelInfo
+{
+    const char *name;
+    const char *description;
+    KernelBatchFn run;
+    void (*prepare)(KernelState &state);
+    bool (*supported)();
+    const char *isa;
+};
+
+static bool alwaysSupported() { return true; }
+
+static void prepareNothing(KernelState &) {}
+
+static void prepareRandomBytes(KernelState &state)
+{
+    std::uint64_t seed = 0x5EEDull;
+
+    state.bytes.resize(std::size_t(1) << 16);
+
+    for(auto &byte : state.bytes) byte = static_cast<std::uint8_t>(nextRandom(seed));
+}
+
+/** Two 16 MiB halves (source, destination): larger than most L2s, so copies stream from L3/DRAM. */
+static constexpr std::size_t copyHalfBytes = std::size_t(16) << 20;
+static constexpr std::size_t copyBlockBytes = 4096u;
+
+static void prepareCopyBuffers(KernelState &state)
+{
+    state.bytes.assign(copyHalfBytes * 2u, std::uint8_t(0x5A));
+}
+
+/** 4M links (16 MiB): a random single cycle, so every load depends on the previous one. */
+static constexpr std::size_t chainLinks = std::size_t(1) << 22;
+
+static void prepareChain(KernelState &state)
+{
+    std::uint64_t seed = 0xC4A1Bull;
+
+    state.chain.resize(chainLinks);
+
+    for(std::size_t k = 0u; k < chainLinks; ++k) state.chain[k] = static_cast<std::uint32_t>(k);
+
+    // Sattolo's shuffle yields one cycle through every link
+    for(std::size_t k = chainLinks - 1u; k > 0u; --k)
+    {
+        const std::size_t j = static_cast<std::size_t>(nextRandom(seed) % k);
+        std::swap(state.chain[k], state.chain[j]);
     }
+}
 
-    // 11) Final summary
-    const auto cycleEndTime = std::chrono::system_clock::now();
-    const std::chrono::duration<double> totalDiff = cycleEndTime - cycleStartTime;
-    const long long totalMs = std::chrono::duration_cast<std::chrono::milliseconds>(totalDiff).count();
+static void prepareCrc(KernelState &state)
+{
+    prepareRandomBytes(state);
+
+    for(std::uint32_t n = 0u; n < 256u; ++n)
+    {
+        std::uint32_t c = n;
 
-    const long long days    = totalMs / (1000LL * 60 * 60 * 24);
-    long long rem     = totalMs % (1000LL * 60 * 60 * 24);
-    const long long hours   = rem / (1000LL * 60 * 60);
-    rem              %= (1000LL * 60 * 60);
-    const long long minutes = rem / (1000LL * 60);
-    rem              %= (1000LL * 60);
-    const long long seconds = rem / 1000LL;
-    const long long ms      = rem % 1000LL;
+        for(int bit = 0; bit < 8; ++bit) c = (c & 1u) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
 
-    std::cout << "******\tSum: " << formatWithCommas(sumOfIterations)
-              << " operations across " << formatWithCommas(cycles) << " cycles *********\n\n";
+        state.crcTable[n] = c;
+    }
+}
 
-    const n_type avgOpsPerSec = (cycles > 0) ? (sumOfIterations / cycles) : 0;
-    std::cout << "Average: " << formatWithCommas(avgOpsPerSec)
-              << " operations per second **********\n\n";
+/*
+ * Portable kernels are written as one operation, step(), over registers that load()
+ * pulls from KernelState and store() writes back. runOps() turns one into the
+ * registry's batch function; the compiled variant matrix below inlines the same
+ * step() with a fixed unroll factor and deadline-check interval.
+ */
 
-    const auto cycleStartStr = dateTimeToString(cycleStartTime);
-    const auto cycleEndStr   = dateTimeToString(cycleEndTime);
+/** The original loop body: one counter increment per operation. */
+struct IncrementOp
+{
+    n_type i;
 
-    std::cout << "Cycle started: " << cycleStartStr
-              << " ... Cycle ended: " << cycleEndStr
-              << " **********\n";
-    std::cout << "Time: " << days << " days " << hours << " hrs "
-              << minutes << " min " << seconds << " sec "
-              << ms << " ms\n";
+    void load(const KernelState &state) { i = state.counter; }
+    void store(KernelState &state) const { state.counter = i; }
 
-    // Write final summary to iteration log
+    void step()
     {
-        std::ofstream itLog(iterationLogPath, std::ios::app);
-        itLog << "******\tSum: " << sumOfIterations
-              << " operations across " << cycles << " cycles *********\n";
-        itLog << "Cycle started: " << cycleStartStr
-              << " ... Cycle ended: " << cycleEndStr << " **********\n";
-        itLog << "Average: " << avgOpsPerSec
-              << " operations per second **********\n";
-        itLog << "Time: " << days << " days " << hours << " hrs "
-              << minutes << " min " << seconds << " sec "
-              << ms << " ms\n";
-        itLog << std::string(33, '_') << "\n\n";
+        ++i;
+        keepCounter(i);
     }
+};
 
-    return 0;
+/** Four dependent integer chains (multiply, xor-shift, rotate, add) per operation. */
+struct IntAluOp
+{
+    std::uint64_t a, b, c, d;
+
+    void load(const KernelState &state) { a = state.acc[0]; b = state.acc[1]; c = state.acc[2]; d = state.acc[3]; }
+    void store(KernelState &state) const { state.acc[0] = a; state.acc[1] = b; state.acc[2] = c; state.acc[3] = d; }
+
+    void step()
+    {
+        a = a * 6364136223846793005ull + 1442695040888963407ull;
+        b ^= a >> 29;
+        b = (b << 7) | (b >> 57);
+        c += b ^ (c >> 11);
+        d = d * 0x9E3779B97F4A7C15ull + c;
+        keepValue(a);
+        keepValue(d);
+    }
+};
+
+template<typename Op>
+static void runOps(KernelState &state, const n_type count)
+{
+    Op op;
+    op.load(state);
+
+    for(n_type n = 0u; n < count; ++n) op.step();
+
+    op.store(state);
+}
+
+#if defined(STRESS_X86)
+static bool fmaSupported() { return __builtin_cpu_supports("fma"); }
+#else
+static bool fmaSupported() { return true; }
+#endif
+
+/** Eight independent fused multiply-add chains per operation. */
+#if defined(STRESS_X86)
+__attribute__((target("fma")))
+#endif
+static void kernelFpFma(KernelState &state, const n_type count)
+{
+    constexpr double m = 0.9999999;
+    constexpr double c = 1e-7;
+
+    double x0 = state.fp[0], x1 = state.fp[1], x2 = state.fp[2], x3 = state.fp[3];
+    double x4 = state.fp[4], x5 = state.fp[5], x6 = state.fp[6], x7 = state.fp[7];
+
+    for(n_type n = 0u; n < count; ++n)
+    {
+        x0 = std::fma(x0, m, c); x1 = std::fma(x1, m, c);
+        x2 = std::fma(x2, m, c); x3 = std::fma(x3, m, c);
+        x4 = std::fma(x4, m, c); x5 = std::fma(x5, m, c);
+        x6 = std::fma(x6, m, c); x7 = std::fma(x7, m, c);
+    }
+
+    state.fp[0] = x0; state.fp[1] = x1; state.fp[2] = x2; state.fp[3] = x3;
+    state.fp[4] = x4; state.fp[5] = x5; state.fp[6] = x6; state.fp[7] = x7;
+}
+
+#if defined(STRESS_X86)
+static bool sse42Supported() { return __builtin_cpu_supports("sse4.2"); }
+static bool avx2Supported() { return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"); }
+static bool avx512Supported() { return __builtin_cpu_supports("avx512f"); }
+
+/** Eight independent 128-bit multiply-adds (16 double lanes) per operation; SSE has no FMA. */
+__attribute__((target("sse4.2")))
+static void kernelSimdSse42(KernelState &state, const n_type count)
+{
+    const __m128d m = _mm_set1_pd(0.9999999);
+    const __m128d c = _mm_set1_pd(1e-7);
+
+    __m128d v0 = _mm_set1_pd(state.fp[0]), v1 = _mm_set1_pd(state.fp[1]);
+    __m128d v2 = _mm_set1_pd(state.fp[2]), v3 = _mm_set1_pd(state.fp[3]);
+    __m128d v4 = _mm_set1_pd(state.fp[4]), v5 = _mm_set1_pd(state.fp[5]);
+    __m128d v6 = _mm_set1_pd(state.fp[6]), v7 = _mm_set1_pd(state.fp[7]);
+
+    for(n_type n = 0u; n < count; ++n)
+    {
+        v0 = _mm_add_pd(_mm_mul_pd(v0, m), c); v1 = _mm_add_pd(_mm_mul_pd(v1, m), c);
+        v2 = _mm_add_pd(_mm_mul_pd(v2, m), c); v3 = _mm_add_pd(_mm_mul_pd(v3, m), c);
+        v4 = _mm_add_pd(_mm_mul_pd(v4, m), c); v5 = _mm_add_pd(_mm_mul_pd(v5, m), c);
+        v6 = _mm_add_pd(_mm_mul_pd(v6, m), c); v7 = _mm_add_pd(_mm_mul_pd(v7, m), c);
+    }
+
+    state.fp[0] = _mm_cvtsd_f64(v0); state.fp[1] = _mm_cvtsd_f64(v1);
+    state.fp[2] = _mm_cvtsd_f64(v2); state.fp[3] = _mm_cvtsd_f64(v3);
+    state.fp[4] = _mm_cvtsd_f64(v4); state.fp[5] = _mm_cvtsd_f64(v5);
+    state.fp[6] = _mm_cvtsd_f64(v6); state.fp[7] = _mm_cvtsd_f64(v7);
+}
+
+/** Eight independent 256-bit FMAs (32 double lanes) per operation. */
+__attribute__((target("avx2,fma")))
+static void kernelSimdAvx2(KernelState &state, const n_type count)
+{
+    const __m256d m = _mm256_set1_pd(0.9999999);
+    const __m256d c = _mm256_set1_pd(1e-7);
+
+    __m256d v0 = _mm256_set1_pd(state.fp[0]), v1 = _mm256_set1_pd(state.fp[1]);
+    __m256d v2 = _mm256_set1_pd(state.fp[2]), v3 = _mm256_set1_pd(state.fp[3]);
+    __m256d v4 = _mm256_set1_pd(state.fp[4]), v5 = _mm256_set1_pd(state.fp[5]);
+    __m256d v6 = _mm256_set1_pd(state.fp[6]), v7 = _mm256_set1_pd(state.fp[7]);
+
+    for(n_type n = 0u; n < count; ++n)
+    {
+        v0 = _mm256_fmadd_pd(v0, m, c); v1 = _mm256_fmadd_pd(v1, m, c);
+        v2 = _mm256_fmadd_pd(v2, m, c); v3 = _mm256_fmadd_pd(v3, m, c);
+        v4 = _mm256_fmadd_pd(v4, m, c); v5 = _mm256_fmadd_pd(v5, m, c);
+        v6 = _mm256_fmadd_pd(v6, m, c); v7 = _mm256_fmadd_pd(v7, m, c);
+    }
+
+    state.fp[0] = _mm256_cvtsd_f64(v0); state.fp[1] = _mm256_cvtsd_f64(v1);
+    state.fp[2] = _mm256_cvtsd_f64(v2); state.fp[3] = _mm256_cvtsd_f64(v3);
+    state.fp[4] = _mm256_cvtsd_f64(v4); state.fp[5] = _mm256_cvtsd_f64(v5);
+    state.fp[6] = _mm256_cvtsd_f64(v6); state.fp[7] = _mm256_cvtsd_f64(v7);
+}
+
+/** Eight independent 512-bit FMAs (64 double lanes) per operation. */
+__attribute__((target("avx512f")))
+static void kernelSimdAvx512(KernelState &state, const n_type count)
+{
+    const __m512d m = _mm512_set1_pd(0.9999999);
+    const __m512d c = _mm512_set1_pd(1e-7);
+
+    __m512d v0 = _mm512_set1_pd(state.fp[0]), v1 = _mm512_set1_pd(state.fp[1]);
+    __m512d v2 = _mm512_set1_pd(state.fp[2]), v3 = _mm512_set1_pd(state.fp[3]);
+    __m512d v4 = _mm512_set1_pd(state.fp[4]), v5 = _mm512_set1_pd(state.fp[5]);
+    __m512d v6 = _mm512_set1_pd(state.fp[6]), v7 = _mm512_set1_pd(state.fp[7]);
+
+    for(n_type n = 0u; n < count; ++n)
+    {
+        v0 = _mm512_fmadd_pd(v0, m, c); v1 = _mm512_fmadd_pd(v1, m, c);
+        v2 = _mm512_fmadd_pd(v2, m, c); v3 = _mm512_fmadd_pd(v3, m, c);
+        v4 = _mm512_fmadd_pd(v4, m, c); v5 = _mm512_fmadd_pd(v5, m, c);
+        v6 = _mm512_fmadd_pd(v6, m, c); v7 = _mm512_fmadd_pd(v7, m, c);
+    }
+
+    state.fp[0] = _mm512_cvtsd_f64(v0); state.fp[1] = _mm512_cvtsd_f64(v1);
+    state.fp[2] = _mm512_cvtsd_f64(v2); state.fp[3] = _mm512_cvtsd_f64(v3);
+    state.fp[4] = _mm512_cvtsd_f64(v4); state.fp[5] = _mm512_cvtsd_f64(v5);
+    state.fp[6] = _mm512_cvtsd_f64(v6); state.fp[7] = _mm512_cvtsd_f64(v7);
+}
+#endif
+
+/** One data-dependent, unpredictable three-way branch per operation. */
+struct BranchyOp
+{
+    const std::uint8_t *data;
+    std::size_t mask, pos;
+    std::uint64_t acc;
+
+    void load(const KernelState &state) { data = state.bytes.data(); mask = state.bytes.size() - 1u; pos = state.cursor; acc = state.acc[0]; }
+    void store(KernelState &state) const { state.cursor = pos; state.acc[0] = acc; }
+
+    void step()
+    {
+        const std::uint8_t v = data[pos];
+        pos = (pos + 1u) & mask;
+
+        // The empty asm statements keep these as real branches instead of cmovs
+        if(v & 0x80u)      { acc += v; asm volatile(""); }
+        else if(v & 0x40u) { acc ^= acc >> 3; asm volatile(""); }
+        else               { acc = acc * 3u + 1u; }
+
+        keepValue(acc);
+    }
+};
+
+/** One 4 KiB memcpy per operation, walking through the 16 MiB source/destination halves. */
+struct MemcpyOp
+{
+    std::uint8_t *src, *dst;
+    std::size_t offset;
+
+    void load(KernelState &state) { src = state.bytes.data(); dst = src + copyHalfBytes; offset = state.cursor; }
+    void store(KernelState &state) const { state.cursor = offset; }
+
+    void step()
+    {
+        std::memcpy(dst + offset, src + offset, copyBlockBytes);
+        asm volatile("" : : "r"(dst) : "memory");
+        offset = (offset + copyBlockBytes) & (copyHalfBytes - 1u);
+    }
+};
+
+/** One dependent load through the random cycle per operation. */
+struct PointerChaseOp
+{
+    const std::uint32_t *chain;
+    std::uint64_t link;
+
+    void load(const KernelState &state) { chain = state.chain.data(); link = state.cursor; }
+    void store(KernelState &state) const { state.cursor = static_cast<std::size_t>(link); }
+
+    void step()
+    {
+        link = chain[link];
+        keepValue(link);
+    }
+};
+
+/** Table-driven CRC-32 (IEEE), one input byte per operation. */
+struct Crc32Op
+{
+    const std::uint8_t *data;
+    const std::uint32_t *table;
+    std::size_t mask, pos;
+    std::uint32_t crc;
+
+    void load(const KernelState &state)
+    {
+        data = state.bytes.data(); table = state.crcTable; mask = state.bytes.size() - 1u;
+        pos = state.cursor; crc = static_cast<std::uint32_t>(state.acc[0]);
+    }
+
+    void store(KernelState &state) const { state.cursor = pos; state.acc[0] = crc; }
+
+    void step()
+    {
+        crc = table[(crc ^ data[pos]) & 0xFFu] ^ (crc >> 8);
+        pos = (pos + 1u) & mask;
+    }
+};
+
+/** Fold one 64-bit input word through the murmur3 finalizer per operation. */
+struct HashOp
+{
+    const std::uint8_t *data;
+    std::size_t mask, pos;
+    std::uint64_t h;
+
+    void load(const KernelState &state) { data = state.bytes.data(); mask = state.bytes.size() - 8u; pos = state.cursor; h = state.acc[0]; }
+    void store(KernelState &state) const { state.cursor = pos; state.acc[0] = h; }
+
+    void step()
+    {
+        std::uint64_t word;
+        std::memcpy(&word, data + pos, sizeof(word));
+        pos = (pos + 8u) & mask;
+
+        h ^= word;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+    }
+};
+
+#if defined(__aarch64__)
+static bool neonSupported() { return (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0u; }
+
+/** Eight independent 128-bit NEON FMAs (16 double lanes) per operation. */
+static void kernelSimdNeon(KernelState &state, const n_type count)
+{
+    const float64x2_t m = vdupq_n_f64(0.9999999);
+    const float64x2_t c = vdupq_n_f64(1e-7);
+
+    float64x2_t v0 = vdupq_n_f64(state.fp[0]), v1 = vdupq_n_f64(state.fp[1]);
+    float64x2_t v2 = vdupq_n_f64(state.fp[2]), v3 = vdupq_n_f64(state.fp[3]);
+    float64x2_t v4 = vdupq_n_f64(state.fp[4]), v5 = vdupq_n_f64(state.fp[5]);
+    float64x2_t v6 = vdupq_n_f64(state.fp[6]), v7 = vdupq_n_f64(state.fp[7]);
+
+    for(n_type n = 0u; n < count; ++n)
+    {
+        v0 = vfmaq_f64(c, v0, m); v1 = vfmaq_f64(c, v1, m);
+        v2 = vfmaq_f64(c, v2, m); v3 = vfmaq_f64(c, v3, m);
+        v4 = vfmaq_f64(c, v4, m); v5 = vfmaq_f64(c, v5, m);
+        v6 = vfmaq_f64(c, v6, m); v7 = vfmaq_f64(c, v7, m);
+    }
+
+    state.fp[0] = vgetq_lane_f64(v0, 0); state.fp[1] = vgetq_lane_f64(v1, 0);
+    state.fp[2] = vgetq_lane_f64(v2, 0); state.fp[3] = vgetq_lane_f64(v3, 0);
+    state.fp[4] = vgetq_lane_f64(v4, 0); state.fp[5] = vgetq_lane_f64(v5, 0);
+    state.fp[6] = vgetq_lane_f64(v6, 0); state.fp[7] = vgetq_lane_f64(v7, 0);
+}
+#else
+static bool neonSupported() { return false; }
+static void kernelSimdNeon(KernelState &state, const n_type count) { kernelFpFma(state, count); }
+#endif
+
+#if !defined(STRESS_X86)
+static bool sse42Supported() { return false; }
+static bool avx2Supported() { return false; }
+static bool avx512Supported() { return false; }
+static void kernelSimdSse42(KernelState &state, const n_type count) { kernelFpFma(state, count); }
+static void kernelSimdAvx2(KernelState &state, const n_type count) { kernelFpFma(state, count); }
+static void kernelSimdAvx512(KernelState &state, const n_type count) { kernelFpFma(state, count); }
+#endif
+
+static const KernelInfo kernelRegistry[] =
+{
+    {"increment",     "original counter increment (default, comparable with older logs)", runOps<IncrementOp>,    prepareNothing,     alwaysSupported, "scalar"},
+    {"int-alu",       "integer multiply/xor/rotate/add chains",                           runOps<IntAluOp>,       prepareNothing,     alwaysSupported, "scalar"},
+    {"fp-fma",        "8 independent double FMA chains",                                  kernelFpFma,            prepareNothing,     fmaSupported,    "fma"},
+    {"simd-sse4.2",   "8 independent 128-bit double multiply-adds",                       kernelSimdSse42,        prepareNothing,     sse42Supported,  "sse4.2"},
+    {"simd-avx2",     "8 independent 256-bit double FMAs",                                kernelSimdAvx2,         prepareNothing,     avx2Supported,   "avx2"},
+    {"simd-avx512",   "8 independent 512-bit double FMAs",                                kernelSimdAvx512,       prepareNothing,     avx512Supported, "avx512f"},
+    {"simd-neon",     "8 independent 128-bit NEON double FMAs",                           kernelSimdNeon,         prepareNothing,     neonSupported,   "neon"},
+    {"branchy",       "unpredictable data-dependent branches",                            runOps<BranchyOp>,      prepareRandomBytes, alwaysSupported, "scalar"},
+    {"memcpy",        "4 KiB copies over a 16 MiB working set",                           runOps<MemcpyOp>,       prepareCopyBuffers, alwaysSupported, "scalar"},
+    {"pointer-chase", "dependent random loads over 16 MiB",                               runOps<PointerChaseOp>, prepareChain,       alwaysSupported, "scalar"},
+    {"crc32",         "table-driven CRC-32, one byte per op",                             runOps<Crc32Op>,        prepareCrc,         alwaysSupported, "scalar"},
+    {"hash",          "murmur3 finalizer over 64-bit words",                              runOps<HashOp>,         prepareRandomBytes, alwaysSupported, "scalar"},
+};
+
+/**
+ * Look a kernel up by name; nullptr if there is none.
+ */
+static const KernelInfo *findKernel(const std::string &name)
+{
+    // "simd" picks the widest vector kernel this CPU runs, so one binary fits every host
+    if(name == "simd")
+    {
+        for(const char *path : {"simd-avx512", "simd-avx2", "simd-neon", "simd-sse4.2"})
+        {
+            const KernelInfo *kernel = findKernel(path);
+
+            if(kernel->supported()) return kernel;
+        }
+
+        return findKernel("fp-fma");
+    }
+
+    for(const KernelInfo &kernel : kernelRegistry)
+    {
+        if(name == kernel.name) return &kernel;
+    }
+
+    return nullptr;
+}
+
+/**
+ * Fold a kernel's live state into a value the optimizer must assume is used.
+ */
+static void consumeKernelState(const KernelState &state)
+{
+    std::uint64_t folded = state.counter ^ state.cursor;
+
+    for(const std::uint64_t a : state.acc) folded ^= a;
+    for(const double x : state.fp) folded ^= static_cast<std::uint64_t>(x * 1e6);
+
+    asm volatile("" : : "r"(folded) : "memory");
+}
+
+/**
+ * Progress is recorded every this many iterations (rounded up to the next check).
+ */
+static constexpr n_type progressInterval = 100000u;
+
+/**
+ * One progress point, kept raw and rendered only after the window closes.
+ */
+struct ProgressSample
+{
+    n_type iteration;
+    std::uint64_t rawNs;
+};
+
+/**
+ * Fixed-capacity store for one worker's samples. Allocated and zero-filled (so its
+ * pages are already faulted in) before the window opens; appending never allocates,
+ * and samples that do not fit are only counted.
+ */
+class SampleArena
+{
+public:
+    SampleArena() = default;
+
+    explicit SampleArena(const std::size_t capacity)
+        : slots_(new ProgressSample[capacity]()), capacity_(capacity)
+    {
+    }
+
+    void append(const ProgressSample &sample)
+    {
+        if(size_ == capacity_)
+        {
+            ++dropped_;
+            return;
+        }
+
+        slots_[size_++] = sample;
+    }
+
+    const ProgressSample *begin() const { return slots_.get(); }
+    const ProgressSample *end() const { return slots_.get() + size_; }
+    std::size_t size() const { return size_; }
+    n_type dropped() const { return dropped_; }
+
+private:
+    std::unique_ptr<ProgressSample[]> slots_;
+    std::size_t capacity_ = 0u;
+    std::size_t size_ = 0u;
+    n_type dropped_ = 0u;
+};
+
+// Destructive-interference distance; 64 bytes on every x86 and most AArch64 parts
+static constexpr std::size_t cacheLineBytes = 64u;
+
+/**
+ * Bounded lock-free single-producer/single-consumer ring. The producer and consumer
+ * indices live on separate cache lines, and the producer keeps a private copy of the
+ * consumer index so a push touches shared state only when the ring looks full.
+ */
+template<typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(const std::size_t capacity)
+    {
+        std::size_t size = 1u;
+        while(size < capacity) size *= 2u;
+
+        slots_.resize(size);
+        mask_ = size - 1u;
+    }
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    /**
+     * Producer side; false (and nothing stored) when the ring is full.
+     */
+    bool push(const T &value)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+
+        if(head - cachedTail_ > mask_)
+        {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+
+            if(head - cachedTail_ > mask_) return false;
+        }
+
+        slots_[head & mask_] = value;
+        head_.store(head + 1u, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * Consumer side: hand every published entry to 'consume', oldest first.
+     */
+    template<typename Fn>
+    std::size_t drain(Fn &&consume)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+
+        for(std::size_t k = tail; k != head; ++k) consume(slots_[k & mask_]);
+
+        tail_.store(head, std::memory_order_release);
+
+        return head - tail;
+    }
+
+private:
+    std::vector<T> slots_;
+    std::size_t mask_ = 0u;
+    alignas(cacheLineBytes) std::atomic<std::size_t> head_{0u};
+    std::size_t cachedTail_ = 0u;
+    alignas(cacheLineBytes) std::atomic<std::size_t> tail_{0u};
+};
+
+// Per-worker sample ring: at >= 20 us per 100K-iteration sample this holds >= 80 ms,
+// far more than the collector's drain period
+static constexpr std::size_t sampleRingCapacity = 4096u;
+static constexpr auto collectorPeriod = std::chrono::milliseconds(10);
+
+using SampleRing = SpscRing<ProgressSample>;
+
+/**
+ * A compiled measurement loop: runs until 'endNs' and returns the raw ns of the
+ * final deadline check, with the operation count in 'iterations'.
+ */
+using VariantLoopFn = std::uint64_t (*)(KernelState &state, std::uint64_t endNs, n_type &iterations,
+                                        SampleRing &samples, n_type &dropped);
+
+template<typename Op, unsigned... Step>
+static inline __attribute__((always_inline)) void unrolledSteps(Op &op, std::integer_sequence<unsigned, Step...>)
+{
+    ((static_cast<void>(Step), op.step()), ...);
+}
+
+/**
+ * Steady-deadline loop with the kernel, unroll factor and check interval fixed at
+ * compile time: step() is inlined 'Unroll' times per inner iteration and the clock
+ * is read every 2^CheckShift operations, with no indirect call in between.
+ */
+template<typename Op, unsigned Unroll, unsigned CheckShift>
+static std::uint64_t variantLoop(KernelState &state, const std::uint64_t endNs, n_type &iterations,
+                                 SampleRing &samples, n_type &dropped)
+{
+    constexpr n_type batch = n_type(1) << CheckShift;
+    static_assert(batch % Unroll == 0u, "check interval must be a multiple of the unroll factor");
+
+    Op op;
+    op.load(state);
+
+    n_type i = 0u;
+    n_type nextSample = progressInterval;
+    std::uint64_t nowNs = 0u;
+
+    do
+    {
+        for(n_type n = 0u; n < batch; n += Unroll)
+        {
+            unrolledSteps(op, std::make_integer_sequence<unsigned, Unroll>());
+        }
+
+        i += batch;
+
+        nowNs = monotonicRawNs();
+
+        if(i >= nextSample)
+        {
+            if(!samples.push({i, nowNs})) ++dropped;
+            nextSample = (i / progressInterval + 1u) * progressInterval;
+        }
+    }
+    while(nowNs < endNs);
+
+    op.store(state);
+    iterations = i;
+
+    return nowNs;
+}
+
+/**
+ * Registry entry for one compiled variant.
+ */
+struct VariantInfo
+{
+    const char *kernel;
+    unsigned unroll;
+    unsigned checkShift;
+    VariantLoopFn loop;
+};
+
+// Every kernel with a step() body, at unroll 1/4/8 and a check every 2^10/2^14/2^18 operations
+#define STRESS_VARIANT_ROW(name, Op, unroll) \
+    {name, unroll, 10u, variantLoop<Op, unroll, 10u>}, \
+    {name, unroll, 14u, variantLoop<Op, unroll, 14u>}, \
+    {name, unroll, 18u, variantLoop<Op, unroll, 18u>}
+
+#define STRESS_VARIANTS(name, Op) \
+    STRESS_VARIANT_ROW(name, Op, 1u), STRESS_VARIANT_ROW(name, Op, 4u), STRESS_VARIANT_ROW(name, Op, 8u)
+
+static const VariantInfo variantRegistry[] =
+{
+    STRESS_VARIANTS("increment",     IncrementOp),
+    STRESS_VARIANTS("int-alu",       IntAluOp),
+    STRESS_VARIANTS("branchy",       BranchyOp),
+    STRESS_VARIANTS("memcpy",        MemcpyOp),
+    STRESS_VARIANTS("pointer-chase", PointerChaseOp),
+    STRESS_VARIANTS("crc32",         Crc32Op),
+    STRESS_VARIANTS("hash",          HashOp),
+};
+
+#undef STRESS_VARIANTS
+#undef STRESS_VARIANT_ROW
+
+/**
+ * The compiled variant for a kernel, unroll factor and check shift; nullptr if that
+ * combination is not in the matrix.
+ */
+static const VariantInfo *findVariant(const std::string &kernel, const unsigned unroll, const unsigned checkShift)
+{
+    for(const VariantInfo &variant : variantRegistry)
+    {
+        if(kernel == variant.kernel && unroll == variant.unroll && checkShift == variant.checkShift) return &variant;
+    }
+
+    return nullptr;
+}
+
+/**
+ * Counter totals for one worker's window. A field is only meaningful when the
+ * matching 'has' flag is set; hosts without a PMU (many VMs) only get the software
+ * context-switch counter.
+ */
+struct PerfCounts
+{
+    bool hasHardware = false;
+    bool hasContextSwitches = false;
+    std::uint64_t cycles = 0u;
+    std::uint64_t instructions = 0u;
+    std::uint64_t llcMisses = 0u;
+    std::uint64_t branchMisses = 0u;
+    std::uint64_t contextSwitches = 0u;
+};
+
+/**
+ * perf_event_open group for the calling thread: cycles leading instructions, LLC
+ * misses and branch misses, plus a separate context-switch counter. Opened disabled
+ * and toggled around the measurement window only.
+ */
+class PerfGroup
+{
+public:
+    PerfGroup() = default;
+
+    ~PerfGroup()
+    {
+        for(const int fd : hwFds_) close(fd);
+        if(swFd_ >= 0) close(swFd_);
+    }
+
+    PerfGroup(const PerfGroup &) = delete;
+    PerfGroup &operator=(const PerfGroup &) = delete;
+
+    /**
+     * Returns false when no counter at all could be opened; errno is kept in error().
+     */
+    bool open()
+    {
+        static const std::uint64_t hwEvents[] =
+        {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+        };
+
+        for(const std::uint64_t event : hwEvents)
+        {
+            const int fd = openEvent(PERF_TYPE_HARDWARE, event, hwFds_.empty() ? -1 : hwFds_.front());
+
+            if(fd < 0)
+            {
+                for(const int opened : hwFds_) close(opened);
+                hwFds_.clear();
+                break;
+            }
+
+            hwFds_.push_back(fd);
+        }
+
+        swFd_ = openEvent(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, -1);
+
+        return !hwFds_.empty() || swFd_ >= 0;
+    }
+
+    int error() const { return error_; }
+
+    void start()
+    {
+        if(!hwFds_.empty())
+        {
+            ioctl(hwFds_.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(hwFds_.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+
+        if(swFd_ >= 0)
+        {
+            ioctl(swFd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(swFd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    void stop()
+    {
+        if(!hwFds_.empty()) ioctl(hwFds_.front(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        if(swFd_ >= 0) ioctl(swFd_, PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    /**
+     * Totals since start(), scaled up if the kernel multiplexed the group.
+     */
+    PerfCounts read() const
+    {
+        PerfCounts counts;
+
+        // PERF_FORMAT_GROUP layout: nr, time_enabled, time_running, values[nr]
+        std::uint64_t group[3 + 4] = {};
+
+        if(!hwFds_.empty() && ::read(hwFds_.front(), group, sizeof(group)) > 0 && group[0] == hwFds_.size() && group[2] > 0u)
+        {
+            const double scale = static_cast<double>(group[1]) / static_cast<double>(group[2]);
+
+            counts.hasHardware  = true;
+            counts.cycles       = static_cast<std::uint64_t>(static_cast<double>(group[3]) * scale);
+            counts.instructions = static_cast<std::uint64_t>(static_cast<double>(group[4]) * scale);
+            counts.llcMisses    = static_cast<std::uint64_t>(static_cast<double>(group[5]) * scale);
+            counts.branchMisses = static_cast<std::uint64_t>(static_cast<double>(group[6]) * scale);
+        }
+
+        std::uint64_t switches[3] = {};
+
+        if(swFd_ >= 0 && ::read(swFd_, switches, sizeof(switches)) > 0)
+        {
+            counts.hasContextSwitches = true;
+            counts.contextSwitches = switches[0];
+        }
+
+        return counts;
+    }
+
+private:
+    int openEvent(const std::uint32_t type, const std::uint64_t config, const int groupFd)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = (groupFd < 0) ? 1 : 0;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING
+                         | ((type == PERF_TYPE_HARDWARE) ? static_cast<std::uint64_t>(PERF_FORMAT_GROUP) : 0u);
+
+        // Count kernel time too when allowed; fall back to user-only under perf_event_paranoid >= 2
+        for(const int excludeKernel : {0, 1})
+        {
+            attr.exclude_kernel = static_cast<std::uint64_t>(excludeKernel);
+
+            const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0ul));
+
+            if(fd >= 0) return fd;
+
+            error_ = errno;
+        }
+
+        return -1;
+    }
+
+    std::vector<int> hwFds_;
+    int swFd_ = -1;
+    int error_ = 0;
+};
+
+/**
+ * How a worker decides its window is over.
+ */
+enum class TimingEngine
+{
+    legacySecond,
+    steadyDeadline,
+    tsc
+};
+
+struct EngineInfo
+{
+    const char *name;
+    TimingEngine engine;
+    const char *description;
+    bool (*supported)();
+};
+
+static const EngineInfo engineRegistry[] =
+{
+    { "steady-deadline", TimingEngine::steadyDeadline, "CLOCK_MONOTONIC_RAW against a fixed deadline (default)", alwaysSupported },
+    { "legacy-second",   TimingEngine::legacySecond,   "until the wall-clock second rolls over, as the original program did", alwaysSupported },
+    { "tsc",             TimingEngine::tsc,            "time-stamp counter against a deadline converted to ticks", tscSupported },
+};
+
+static const EngineInfo *findEngine(const std::string &name)
+{
+    for(const EngineInfo &engine : engineRegistry)
+    {
+        if(name == engine.name) return &engine;
+    }
+
+    return nullptr;
+}
+
+/**
+ * Frequency, temperature, package energy and throttling over one window. Sources a
+ * host does not expose (VMs, restricted containers) leave their 'has' flag false.
+ * 'ghz' is effective: perf cycles / elapsed when counters ran, else the mean sampled
+ * scaling_cur_freq. 'opsPerJoule' is the window's total operations per package joule.
+ */
+struct Telemetry
+{
+    bool hasFrequency = false;
+    bool hasTemperature = false;
+    bool hasEnergy = false;
+    bool hasThrottle = false;
+    double ghz = 0.0;
+    double maxTempC = 0.0;
+    double joules = 0.0;
+    double watts = 0.0;
+    double opsPerJoule = 0.0;
+    n_type throttleEvents = 0u;
+    std::uint64_t elapsedNs = 0u;
+};
+
+// Telemetry sampling period; sysfs reads are a few us, so this costs well under 0.1%
+static constexpr auto telemetryPeriod = std::chrono::milliseconds(100);
+
+/**
+ * Background sampler for Telemetry. Every sysfs file is opened once up front and
+ * re-read with pread, so a sample costs no open/close or allocation. start() and
+ * stop() each take a sample on the calling thread; the sampler thread adds one
+ * every telemetryPeriod in between (temperature peaks, energy counter wraps).
+ */
+class TelemetrySampler
+{
+public:
+    TelemetrySampler()
+    {
+        std::error_code ec;
+
+        for(const auto &zone : fs::directory_iterator("/sys/class/thermal", ec))
+        {
+            if(zone.path().filename().string().rfind("thermal_zone", 0) == 0) addFd(thermalFds_, zone.path() / "temp");
+        }
+
+        for(const auto &domain : fs::directory_iterator("/sys/class/powercap", ec))
+        {
+            std::ifstream nameFile(domain.path() / "name");
+            std::string name;
+
+            if(!(nameFile >> name) || name.rfind("package", 0) != 0) continue;
+
+            EnergyCounter counter;
+            counter.fd = ::open((domain.path() / "energy_uj").c_str(), O_RDONLY);
+
+            if(counter.fd < 0)
+            {
+                energyDenied_ = true;
+                continue;
+            }
+
+            std::ifstream range(domain.path() / "max_energy_range_uj");
+            range >> counter.rangeUj;
+            energy_.push_back(counter);
+        }
+
+        for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            const fs::path base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+
+            if(!fs::exists(base, ec)) break;
+
+            CpuFiles files;
+            files.freq = ::open((base / "cpufreq/scaling_cur_freq").c_str(), O_RDONLY);
+            files.coreThrottle = ::open((base / "thermal_throttle/core_throttle_count").c_str(), O_RDONLY);
+            files.packageThrottle = ::open((base / "thermal_throttle/package_throttle_count").c_str(), O_RDONLY);
+            cpus_.push_back(files);
+        }
+    }
+
+    ~TelemetrySampler()
+    {
+        for(const int fd : thermalFds_) ::close(fd);
+        for(const EnergyCounter &counter : energy_) ::close(counter.fd);
+
+        for(const CpuFiles &files : cpus_)
+        {
+            for(const int fd : {files.freq, files.coreThrottle, files.packageThrottle}) if(fd >= 0) ::close(fd);
+        }
+    }
+
+    TelemetrySampler(const TelemetrySampler &) = delete;
+    TelemetrySampler &operator=(const TelemetrySampler &) = delete;
+
+    /**
+     * What this host exposes, for the run header.
+     */
+    std::string sources() const
+    {
+        std::size_t freq = 0u;
+        std::size_t throttle = 0u;
+
+        for(const CpuFiles &files : cpus_)
+        {
+            freq += files.freq >= 0;
+            throttle += files.coreThrottle >= 0;
+        }
+
+        std::ostringstream out;
+        out << "cpufreq on " << freq << " CPU(s), " << thermalFds_.size() << " thermal zone(s), "
+            << energy_.size() << " RAPL package(s)" << (energyDenied_ ? " (energy_uj not readable)" : "")
+            << ", throttle counters on " << throttle << " CPU(s)";
+
+        return out.str();
+    }
+
+    /**
+     * Begin a window on 'cpus' (-1 entries mean unpinned: every CPU is sampled).
+     */
+    void start(const std::vector<int> &cpus)
+    {
+        watched_.clear();
+
+        for(const int cpu : cpus)
+        {
+            if(cpu < 0)
+            {
+                watched_.clear();
+                for(std::size_t k = 0u; k < cpus_.size(); ++k) watched_.push_back(static_cast<int>(k));
+                break;
+            }
+
+            if(static_cast<std::size_t>(cpu) < cpus_.size()) watched_.push_back(cpu);
+        }
+
+        current_ = Telemetry{};
+        freqSum_ = 0.0;
+        freqSamples_ = 0u;
+        joules_ = 0.0;
+        lastEnergy_.assign(energy_.size(), -1.0);
+        throttleStart_ = readThrottle();
+        startNs_ = monotonicRawNs();
+        sample();
+
+        stop_ = false;
+        thread_ = std::thread([this]()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            while(!wake_.wait_for(lock, telemetryPeriod, [this]() { return stop_; })) sample();
+        });
+    }
+
+    Telemetry stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+
+        wake_.notify_one();
+        thread_.join();
+        sample();
+
+        current_.elapsedNs = monotonicRawNs() - startNs_;
+
+        if(freqSamples_)
+        {
+            current_.hasFrequency = true;
+            current_.ghz = freqSum_ / freqSamples_ / 1e6;
+        }
+
+        if(!energy_.empty() && current_.elapsedNs)
+        {
+            current_.hasEnergy = true;
+            current_.joules = joules_;
+            current_.watts = joules_ / (static_cast<double>(current_.elapsedNs) / 1e9);
+        }
+
+        const double throttleEnd = readThrottle();
+
+        if(throttleEnd >= 0.0 && throttleStart_ >= 0.0)
+        {
+            current_.hasThrottle = true;
+            current_.throttleEvents = static_cast<n_type>(std::max(0.0, throttleEnd - throttleStart_));
+        }
+
+        return current_;
+    }
+
+private:
+    struct EnergyCounter
+    {
+        int fd = -1;
+        double rangeUj = 0.0;
+    };
+
+    struct CpuFiles
+    {
+        int freq = -1;
+        int coreThrottle = -1;
+        int packageThrottle = -1;
+    };
+
+    static void addFd(std::vector<int> &fds, const fs::path &path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd >= 0) fds.push_back(fd);
+    }
+
+    static bool readNumber(const int fd, double &value)
+    {
+        char text[32];
+        const ssize_t n = (fd >= 0) ? pread(fd, text, sizeof(text) - 1u, 0) : -1;
+
+        if(n <= 0) return false;
+
+        text[n] = '\0';
+        char *end = nullptr;
+        value = std::strtod(text, &end);
+
+        return end != text;
+    }
+
+    /**
+     * Core throttle events on the watched CPUs plus package events (counted once,
+     * from the largest package counter); -1 when no CPU exposes the counters.
+     */
+    double readThrottle() const
+    {
+        double core = 0.0;
+        double package = 0.0;
+        bool any = false;
+        double value = 0.0;
+
+        for(const int cpu : watched_)
+        {
+            if(readNumber(cpus_[cpu].coreThrottle, value)) { core += value; any = true; }
+            if(readNumber(cpus_[cpu].packageThrottle, value)) package = std::max(package, value);
+        }
+
+        return any ? core + package : -1.0;
+    }
+
+    void sample()
+    {
+        double value = 0.0;
+        double freq = 0.0;
+        unsigned freqCpus = 0u;
+
+        for(const int cpu : watched_)
+        {
+            if(readNumber(cpus_[cpu].freq, value)) { freq += value; ++freqCpus; }
+        }
+
+        if(freqCpus) { freqSum_ += freq / freqCpus; ++freqSamples_; }
+
+        for(const int fd : thermalFds_)
+        {
+            if(!readNumber(fd, value)) continue;
+
+            current_.hasTemperature = true;
+            current_.maxTempC = std::max(current_.maxTempC, value / 1000.0);
+        }
+
+        // RAPL counters are monotonic modulo max_energy_range_uj
+        for(std::size_t k = 0u; k < energy_.size(); ++k)
+        {
+            if(!readNumber(energy_[k].fd, value)) continue;
+
+            if(lastEnergy_[k] >= 0.0)
+            {
+                const double delta = value - lastEnergy_[k];
+                joules_ += ((delta >= 0.0) ? delta : delta + energy_[k].rangeUj) / 1e6;
+            }
+
+            lastEnergy_[k] = value;
+        }
+    }
+
+    std::vector<int> thermalFds_;
+    std::vector<EnergyCounter> energy_;
+    std::vector<CpuFiles> cpus_;
+    bool energyDenied_ = false;
+    std::vector<int> watched_;
+    std::vector<double> lastEnergy_;
+    Telemetry current_;
+    double freqSum_ = 0.0;
+    unsigned freqSamples_ = 0u;
+    double joules_ = 0.0;
+    double throttleStart_ = -1.0;
+    std::uint64_t startNs_ = 0u;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+/**
+ * Render a window's telemetry as one detail line; "n/a" for what the host lacks.
+ */
+static std::string renderTelemetry(const Telemetry &t)
+{
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out << std::fixed << "Telemetry ";
+
+    if(t.hasFrequency) out << std::setprecision(2) << t.ghz << " GHz effective"; else out << "GHz n/a";
+    if(t.hasTemperature) out << ", " << std::setprecision(1) << t.maxTempC << " C peak"; else out << ", temperature n/a";
+
+    if(t.hasEnergy)
+    {
+        out << ", " << std::setprecision(2) << t.watts << " W package, " << std::setprecision(0) << t.opsPerJoule << " ops/J";
+    }
+    else
+    {
+        out << ", package power n/a";
+    }
+
+    if(t.hasThrottle) out << ", " << t.throttleEvents << " throttle events"; else out << ", throttle counters n/a";
+
+    return out.str();
+}
+
+/**
+ * Fold one window into a run total: GHz averaged over the windows that had it,
+ * energy and throttle events summed, watts and ops/J over the summed energy and time.
+ */
+static void mergeTelemetry(Telemetry &total, n_type &frequencyWindows, const Telemetry &window)
+{
+    if(window.hasFrequency)
+    {
+        total.ghz = (total.ghz * frequencyWindows + window.ghz) / (frequencyWindows + 1u);
+        total.hasFrequency = true;
+        ++frequencyWindows;
+    }
+
+    if(window.hasTemperature)
+    {
+        total.maxTempC = std::max(total.maxTempC, window.maxTempC);
+        total.hasTemperature = true;
+    }
+
+    if(window.hasEnergy && window.joules > 0.0)
+    {
+        const double operations = total.opsPerJoule * total.joules + window.opsPerJoule * window.joules;
+
+        total.joules += window.joules;
+        total.elapsedNs += window.elapsedNs;
+        total.watts = total.joules / (static_cast<double>(total.elapsedNs) / 1e9);
+        total.opsPerJoule = operations / total.joules;
+        total.hasEnergy = true;
+    }
+
+    if(window.hasThrottle)
+    {
+        total.throttleEvents += window.throttleEvents;
+        total.hasThrottle = true;
+    }
+}
+
+/**
+ * One worker's share of a mixed-workload profile: its own kernel and clock-check
+ * interval, busy for 'dutyPct' of every 'periodNs' and idle for the rest.
+ */
+struct WorkerMix
+{
+    const KernelInfo *kernel = nullptr;
+    unsigned checkShift = 16u;
+    unsigned dutyPct = 100u;
+    std::uint64_t periodNs = 10000000u;
+    unsigned workload = 0u;
+};
+
+/**
+ * Shared start/stop instants for one measurement window, on the monotonicRawNs() clock.
+ * Workers park on 'go' and then spin until startNs so every core begins together.
+ * 'ready' and 'go' get their own cache lines so check-ins do not disturb the spinners.
+ */
+struct CycleWindow
+{
+    alignas(cacheLineBytes) std::atomic<unsigned> ready{0u};
+    alignas(cacheLineBytes) std::atomic<bool> go{false};
+    alignas(cacheLineBytes) std::uint64_t startNs = 0u;
+    std::uint64_t endNs = 0u;
+    unsigned checkShift = 16u;
+    std::size_t sampleCapacity = 0u;
+    const KernelInfo *kernel = nullptr;
+    std::uint64_t warmupNs = 0u;
+    bool perfCounters = false;
+    TimingEngine engine = TimingEngine::steadyDeadline;
+    const TscClock *tsc = nullptr;
+    const VariantInfo *variant = nullptr;
+    TelemetrySampler *telemetry = nullptr;
+    std::time_t legacySeconds = 1;
+    const WorkerMix *mix = nullptr;
+};
+
+/**
+ * What one worker measured during a window. Each slot is cache-line aligned so a
+ * worker never shares a line with its neighbour's result; progress samples reach
+ * 'samples' through the worker's ring and the collector, not from the worker.
+ */
+struct alignas(cacheLineBytes) WorkerResult
+{
+    n_type iterations = 0u;
+    n_type droppedSamples = 0u;
+    std::uint64_t elapsedNs = 0u;
+    int cpu = -1;
+    int lastCpu = -1;
+    bool pinned = false;
+    std::uint64_t warmupNs = 0u;
+    bool warmupStable = false;
+    double cpuMhz = 0.0;
+    bool perfOpened = false;
+    int perfError = 0;
+    PerfCounts perf;
+    SampleArena samples;
+};
+
+/**
+ * CPUs this process may run on, in ascending order.
+ */
+static std::vector<int> getAllowedCpus()
+{
+    std::vector<int> cpus;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    if(sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if(CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+
+    if(cpus.empty()) cpus.push_back(0);
+
+    return cpus;
+}
+
+/**
+ * CPU controller of the cgroup this process runs in. quotaCpus is 0 when there is no
+ * CFS quota anywhere up the hierarchy; statPath is empty when cpu.stat is not readable.
+ */
+struct CgroupCpu
+{
+    int version = 0;
+    std::string path;
+    double quotaCpus = 0.0;
+    long long quotaUs = 0;
+    long long periodUs = 0;
+    std::string cpuset;
+    fs::path statPath;
+};
+
+/**
+ * Cumulative CFS throttling counters from cpu.stat; throttledMs is converted from
+ * throttled_usec (v2) or throttled_time in ns (v1).
+ */
+struct CgroupThrottle
+{
+    bool valid = false;
+    n_type periods = 0u;
+    n_type throttled = 0u;
+    double throttledMs = 0.0;
+};
+
+static std::string readTrimmedLine(const fs::path &file)
+{
+    std::ifstream in(file);
+    std::string line;
+    std::getline(in, line);
+
+    while(!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) line.pop_back();
+
+    return line;
+}
+
+/**
+ * Directory of 'cgroupPath' under the hierarchy mounted at 'mount' with root 'root'
+ * (both from mountinfo). Inside a cgroup namespace the path is often not visible under
+ * the mount, in which case the mount itself is the process's cgroup.
+ */
+static fs::path cgroupDirectory(const std::string &mount, const std::string &root, const std::string &cgroupPath)
+{
+    std::string relative = cgroupPath;
+
+    if(root != "/" && relative.compare(0u, root.size(), root) == 0) relative.erase(0u, root.size());
+
+    std::error_code ec;
+    const fs::path dir = fs::path(mount) / fs::path(relative).relative_path();
+
+    return fs::is_directory(dir, ec) ? dir : fs::path(mount);
+}
+
+/**
+ * CFS quota of 'dir' in CPUs, or 0 for none. Walks up to 'mount' since a parent's quota
+ * caps every child below it; quotaUs/periodUs report the tightest one.
+ */
+static double cgroupQuota(fs::path dir, const fs::path &mount, const int version, long long &quotaUs, long long &periodUs)
+{
+    double best = 0.0;
+
+    for(;;)
+    {
+        long long quota = -1;
+        long long period = 0;
+
+        if(version == 2)
+        {
+            std::istringstream in(readTrimmedLine(dir / "cpu.max"));
+            std::string first;
+
+            if(in >> first >> period && first != "max") quota = std::atoll(first.c_str());
+        }
+        else
+        {
+            const std::string quotaText = readTrimmedLine(dir / "cpu.cfs_quota_us");
+            const std::string periodText = readTrimmedLine(dir / "cpu.cfs_period_us");
+
+            if(!quotaText.empty() && !periodText.empty())
+            {
+                quota = std::atoll(quotaText.c_str());
+                period = std::atoll(periodText.c_str());
+            }
+        }
+
+        if(quota > 0 && period > 0)
+        {
+            const double cpus = static_cast<double>(quota) / static_cast<double>(period);
+
+            if(best == 0.0 || cpus < best)
+            {
+                best = cpus;
+                quotaUs = quota;
+                periodUs = period;
+            }
+        }
+
+        if(dir == mount || !dir.has_relative_path() || dir.parent_path() == dir) break;
+        dir = dir.parent_path();
+    }
+
+    return best;
+}
+
+/**
+ * Find this process's CPU cgroup from /proc/self/cgroup and /proc/self/mountinfo. A v2
+ * hierarchy is used when it carries the cpu controller, otherwise the v1 "cpu" one
+ * (hybrid hosts mount both). version stays 0 when neither is found.
+ */
+static CgroupCpu detectCgroupCpu()
+{
+    CgroupCpu cg;
+    std::string v2Path;
+    std::string v1CpuPath;
+    std::string v1CpusetPath;
+    bool hasV2 = false;
+
+    {
+        std::ifstream in("/proc/self/cgroup");
+        std::string line;
+
+        while(std::getline(in, line))
+        {
+            // hierarchy-ID:controller-list:path
+            const std::size_t first = line.find(':');
+            const std::size_t second = (first == std::string::npos) ? first : line.find(':', first + 1u);
+
+            if(second == std::string::npos) continue;
+
+            const std::string controllers = line.substr(first + 1u, second - first - 1u);
+            const std::string path = line.substr(second + 1u);
+
+            if(line.compare(0u, first, "0") == 0 && controllers.empty())
+            {
+                hasV2 = true;
+                v2Path = path;
+                continue;
+            }
+
+            std::istringstream list(controllers);
+            std::string controller;
+
+            while(std::getline(list, controller, ','))
+            {
+                if(controller == "cpu") v1CpuPath = path;
+                if(controller == "cpuset") v1CpusetPath = path;
+            }
+        }
+    }
+
+    fs::path v2Dir, v2Mount, cpuDir, cpuMount, cpusetDir;
+
+    {
+        std::ifstream in("/proc/self/mountinfo");
+        std::string line;
+
+        while(std::getline(in, line))
+        {
+            // id parent major:minor root mount-point options [optional...] - fstype source super-options
+            std::istringstream fields(line);
+            std::string id, parent, device, root, mount, field;
+
+            if(!(fields >> id >> parent >> device >> root >> mount)) continue;
+
+            while(fields >> field && field != "-") {}
+
+            std::string fstype, source, superOptions;
+            if(!(fields >> fstype >> source >> superOptions)) continue;
+
+            if(fstype == "cgroup2" && hasV2 && v2Dir.empty())
+            {
+                v2Mount = mount;
+                v2Dir = cgroupDirectory(mount, root, v2Path);
+            }
+            else if(fstype == "cgroup")
+            {
+                std::istringstream options(superOptions);
+                std::string option;
+
+                while(std::getline(options, option, ','))
+                {
+                    if(option == "cpu" && !v1CpuPath.empty() && cpuDir.empty())
+                    {
+                        cpuMount = mount;
+                        cpuDir = cgroupDirectory(mount, root, v1CpuPath);
+                    }
+
+                    if(option == "cpuset" && !v1CpusetPath.empty() && cpusetDir.empty())
+                    {
+                        cpusetDir = cgroupDirectory(mount, root, v1CpusetPath);
+                    }
+                }
+            }
+        }
+    }
+
+    std::error_code ec;
+
+    if(!v2Dir.empty() && (fs::exists(v2Dir / "cpu.max", ec) || fs::exists(v2Dir / "cpu.stat", ec)) && cpuDir.empty())
+    {
+        cg.version = 2;
+        cg.path = v2Path;
+        cg.quotaCpus = cgroupQuota(v2Dir, v2Mount, 2, cg.quotaUs, cg.periodUs);
+        cg.cpuset = readTrimmedLine(v2Dir / "cpuset.cpus.effective");
+        if(fs::exists(v2Dir / "cpu.stat", ec)) cg.statPath = v2Dir / "cpu.stat";
+    }
+    else if(!cpuDir.empty())
+    {
+        cg.version = 1;
+        cg.path = v1CpuPath;
+        cg.quotaCpus = cgroupQuota(cpuDir, cpuMount, 1, cg.quotaUs, cg.periodUs);
+        if(fs::exists(cpuDir / "cpu.stat", ec)) cg.statPath = cpuDir / "cpu.stat";
+
+        if(!cpusetDir.empty())
+        {
+            cg.cpuset = readTrimmedLine(cpusetDir / "cpuset.effective_cpus");
+            if(cg.cpuset.empty()) cg.cpuset = readTrimmedLine(cpusetDir / "cpuset.cpus");
+        }
+    }
+
+    return cg;
+}
+
+/**
+ * Current throttling counters; read outside the window so the file I/O is not timed.
+ */
+static CgroupThrottle readCgroupThrottle(const CgroupCpu &cg)
+{
+    CgroupThrottle t;
+    if(cg.statPath.empty()) return t;
+
+    std::ifstream in(cg.statPath);
+    std::string key;
+    n_type value = 0u;
+
+    while(in >> key >> value)
+    {
+        if(key == "nr_periods") { t.periods = value; t.valid = true; }
+        else if(key == "nr_throttled") t.throttled = value;
+        else if(key == "throttled_usec") t.throttledMs = value / 1e3;
+        else if(key == "throttled_time") t.throttledMs = value / 1e6;
+    }
+
+    return t;
+}
+
+/**
+ * Counters accumulated between two reads.
+ */
+static CgroupThrottle cgroupThrottleDelta(const CgroupThrottle &before, const CgroupThrottle &after)
+{
+    CgroupThrottle d;
+    d.valid = before.valid && after.valid;
+    if(!d.valid) return d;
+
+    d.periods = after.periods - before.periods;
+    d.throttled = after.throttled - before.throttled;
+    d.throttledMs = std::max(0.0, after.throttledMs - before.throttledMs);
+
+    return d;
+}
+
+static std::string renderCgroupThrottle(const CgroupThrottle &t)
+{
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out << std::fixed << std::setprecision(1)
+        << "Cgroup throttled in " << t.throttled << " of " << t.periods << " CFS periods, " << t.throttledMs << " ms";
+
+    return out.str();
+}
+
+/**
+ * Run header line: version, quota and cpuset.
+ */
+static std::string renderCgroupCpu(const CgroupCpu &cg)
+{
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out << "Cgroup v" << cg.version << " " << cg.path << ": ";
+
+    if(cg.quotaCpus > 0.0)
+    {
+        out << "CPU quota " << std::fixed << std::setprecision(2) << cg.quotaCpus << " CPUs (" << cg.quotaUs << " us per " << cg.periodUs << " us)";
+    }
+    else out << "no CPU quota";
+
+    if(!cg.cpuset.empty()) out << ", cpuset " << cg.cpuset;
+    if(cg.statPath.empty()) out << ", throttle counters n/a";
+
+    return out.str();
+}
+
+/**
+ * Bind the calling thread to a single CPU.
+ */
+static bool pinThreadToCpu(const int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+/**
+ * Current frequency of a CPU in MHz: cpufreq if the host exposes it, otherwise the
+ * "cpu MHz" line of /proc/cpuinfo. 0 when neither is available.
+ */
+static double readCpuFrequencyMhz(const int cpu)
+{
+    if(cpu < 0) return 0.0;
+
+    std::ifstream cpufreq("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq");
+    double khz = 0.0;
+
+    if(cpufreq >> khz) return khz / 1000.0;
+
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    int processor = -1;
+
+    while(std::getline(cpuinfo, line))
+    {
+        if(line.rfind("processor", 0) == 0) processor = std::atoi(line.c_str() + line.find(':') + 1);
+        else if(processor == cpu && line.rfind("cpu MHz", 0) == 0) return std::atof(line.c_str() + line.find(':') + 1);
+    }
+
+    return 0.0;
+}
+
+/**
+ * CPU model string: "model name" from /proc/cpuinfo on x86, otherwise the first
+ * "Hardware" or "CPU part" line, "unknown" when none is present.
+ */
+static std::string cpuModelName()
+{
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    std::string fallback = "unknown";
+
+    while(std::getline(cpuinfo, line))
+    {
+        const std::size_t colon = line.find(':');
+        if(colon == std::string::npos) continue;
+
+        std::string value = line.substr(colon + 1u);
+        value.erase(0u, value.find_first_not_of(" \t"));
+
+        if(line.rfind("model name", 0) == 0) return value;
+        if(fallback == "unknown" && (line.rfind("Hardware", 0) == 0 || line.rfind("CPU part", 0) == 0)) fallback = value;
+    }
+
+    return fallback;
+}
+
+/**
+ * Ops/sec for a worker, normalized by the time it actually spent in the window.
+ */
+static double opsPerSecond(const WorkerResult &result)
+{
+    const double seconds = static_cast<double>(result.elapsedNs) / 1e9;
+
+    return (seconds > 0.0) ? static_cast<double>(result.iterations) / seconds : 0.0;
+}
+
+/**
+ * Outcome of the startup calibration.
+ */
+struct Calibration
+{
+    unsigned checkShift = 16u;
+    double iterationNs = 1.0;
+    double clockNs = 20.0;
+};
+
+/**
+ * Pick how many iterations run between deadline checks, as a power of two.
+ * Large enough that one clock read costs <0.1% of the work between checks,
+ * small enough that the window overshoots its deadline by <0.1%.
+ */
+static Calibration calibrateCheckShift(const std::uint64_t windowNs, const KernelInfo &kernel)
+{
+    constexpr unsigned minShift = 6u;
+    constexpr unsigned maxShift = 26u;
+    constexpr int clockReads = 4096;
+    constexpr std::uint64_t probeNs = 2000000u;
+
+    const std::uint64_t clockStart = monotonicRawNs();
+    std::uint64_t last = clockStart;
+
+    for(int r = 0; r < clockReads; ++r)
+    {
+        last = monotonicRawNs();
+    }
+
+    const double clockNs = static_cast<double>(last - clockStart) / clockReads;
+
+    // Time the kernel itself, doubling the probe until it runs for ~2ms
+    KernelState state;
+    kernel.prepare(state);
+
+    n_type probeIterations = 64u;
+    std::uint64_t probeElapsed = 0u;
+
+    for(;;)
+    {
+        const std::uint64_t loopStart = monotonicRawNs();
+        kernel.run(state, probeIterations);
+        probeElapsed = monotonicRawNs() - loopStart;
+
+        if(probeElapsed >= probeNs || probeIterations >= (n_type(1) << 30)) break;
+
+        probeIterations *= 2u;
+    }
+
+    consumeKernelState(state);
+
+    const double iterationNs = std::max(static_cast<double>(probeElapsed) / probeIterations, 0.01);
+
+    const double wantIterations = clockNs * 1000.0 / iterationNs;
+    const double maxIterations  = static_cast<double>(windowNs) / 1000.0 / iterationNs;
+
+    unsigned shift = minShift;
+
+    while(shift < maxShift && static_cast<double>(n_type(1) << shift) < wantIterations) ++shift;
+    while(shift > minShift && static_cast<double>(n_type(1) << shift) > maxIterations) --shift;
+
+    Calibration calibration;
+    calibration.checkShift  = shift;
+    calibration.iterationNs = iterationNs;
+    calibration.clockNs     = clockNs;
+
+    return calibration;
+}
+
+/**
+ * Spin a kernel in 5 ms slices until three consecutive slices run within 1% of each
+ * other (the core's clock has settled) or 'budgetNs' runs out. Returns ns spent.
+ */
+static std::uint64_t warmUp(const KernelInfo &kernel, KernelState &state, const n_type batch,
+                            const std::uint64_t budgetNs, bool &stable)
+{
+    constexpr std::uint64_t sliceNs = 5000000u;
+
+    const std::uint64_t startNs    = monotonicRawNs();
+    const std::uint64_t deadlineNs = startNs + budgetNs;
+    std::uint64_t nowNs = startNs;
+    double lastRate = 0.0;
+    int matching = 0;
+
+    stable = false;
+
+    while(!stable && nowNs < deadlineNs)
+    {
+        const std::uint64_t sliceStart = nowNs;
+        n_type ops = 0u;
+
+        while(nowNs - sliceStart < sliceNs && nowNs < deadlineNs)
+        {
+            kernel.run(state, batch);
+            ops += batch;
+            nowNs = monotonicRawNs();
+        }
+
+        const double rate = static_cast<double>(ops) / static_cast<double>(nowNs - sliceStart);
+
+        matching = (lastRate > 0.0 && std::fabs(rate - lastRate) <= lastRate * 0.01) ? matching + 1 : 0;
+        stable = matching >= 2;
+        lastRate = rate;
+    }
+
+    return nowNs - startNs;
+}
+
+/**
+ * Body of one worker thread: pin, prepare the kernel, optionally warm up, report
+ * ready, wait for the shared start instant, then run the kernel until the window's
+ * timing engine says it is over. The clock is read only once per 2^checkShift
+ * iterations and progress is stored as raw samples.
+ */
+static void runWorker(CycleWindow &window, WorkerResult &result, SampleRing &samples, const int cpu,
+                      const WorkerMix *mix)
+{
+    if(cpu >= 0)
+    {
+        result.cpu = cpu;
+        result.pinned = pinThreadToCpu(cpu);
+    }
+
+    const KernelInfo &kernel = mix ? *mix->kernel : *window.kernel;
+    const unsigned checkShift = mix ? mix->checkShift : window.checkShift;
+    KernelState state;
+    kernel.prepare(state);
+
+    if(window.warmupNs > 0u)
+    {
+        result.warmupNs = warmUp(kernel, state, n_type(1) << checkShift, window.warmupNs, result.warmupStable);
+    }
+
+    // Counters are opened per thread, outside the window; only enable/disable sit at its edges
+    PerfGroup perf;
+
+    if(window.perfCounters)
+    {
+        result.perfOpened = perf.open();
+        result.perfError  = perf.error();
+    }
+
+    window.ready.fetch_add(1u, std::memory_order_acq_rel);
+
+    while(!window.go.load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+
+    const std::uint64_t startNs = window.startNs;
+    const std::uint64_t endNs   = window.endNs;
+    const n_type batch = n_type(1) << checkShift;
+
+    if(window.engine == TimingEngine::tsc)
+    {
+        const std::uint64_t startTicks = window.tsc->toTicks(startNs);
+
+        while(window.tsc->orderedNow() < startTicks)
+        {
+        }
+    }
+    else
+    {
+        while(monotonicRawNs() < startNs)
+        {
+        }
+    }
+
+    if(result.perfOpened) perf.start();
+
+    n_type i = 0u;
+    n_type nextSample = progressInterval;
+    std::uint64_t nowNs = startNs;
+
+    // Record progress once i has passed the next 100K boundary
+    const auto recordSample = [&](const std::uint64_t stampNs)
+    {
+        if(!samples.push({i, stampNs})) ++result.droppedSamples;
+        nextSample = (i / progressInterval + 1u) * progressInterval;
+    };
+
+    // Loop until the window has elapsed, checking the engine's clock once per batch
+    if(window.engine == TimingEngine::legacySecond)
+    {
+        // Window runs from here to the legacySeconds-th wall-clock second boundary, so
+        // its length varies by up to a second
+        const std::time_t endSecond = wallClockNow().tv_sec + window.legacySeconds;
+        timespec nowTs{};
+
+        do
+        {
+            kernel.run(state, batch);
+            i += batch;
+
+            nowTs = wallClockNow();
+
+            if(i >= nextSample) recordSample(monotonicRawNs());
+        }
+        while(nowTs.tv_sec < endSecond);
+
+        nowNs = monotonicRawNs();
+    }
+    else if(window.engine == TimingEngine::tsc)
+    {
+        // Plain rdtsc inside the loop; only the closing read is serialized
+        const TscClock &tsc = *window.tsc;
+        const std::uint64_t endTicks = tsc.toTicks(endNs);
+        std::uint64_t nowTicks = 0u;
+
+        do
+        {
+            kernel.run(state, batch);
+            i += batch;
+
+            nowTicks = readTsc();
+
+            if(i >= nextSample) recordSample(tsc.toNs(nowTicks));
+        }
+        while(nowTicks < endTicks);
+
+        nowNs = tsc.toNs(tsc.orderedNow());
+    }
+    else if(window.variant != nullptr)
+    {
+        nowNs = window.variant->loop(state, endNs, i, samples, result.droppedSamples);
+    }
+    else if(mix != nullptr && mix->dutyPct < 100u)
+    {
+        // Duty cycle: busy from the start of each period, then asleep until the next
+        const std::uint64_t busyNs = mix->periodNs * mix->dutyPct / 100u;
+
+        for(std::uint64_t periodNs = startNs; nowNs < endNs; periodNs += mix->periodNs)
+        {
+            const std::uint64_t busyEndNs = std::min(periodNs + busyNs, endNs);
+            const std::uint64_t idleEndNs = std::min(periodNs + mix->periodNs, endNs);
+
+            while(nowNs < busyEndNs)
+            {
+                kernel.run(state, batch);
+                i += batch;
+
+                nowNs = monotonicRawNs();
+
+                if(i >= nextSample) recordSample(nowNs);
+            }
+
+            if(nowNs < idleEndNs)
+            {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(idleEndNs - nowNs));
+                nowNs = monotonicRawNs();
+            }
+        }
+    }
+    else
+    {
+        do
+        {
+            kernel.run(state, batch);
+            i += batch;
+
+            nowNs = monotonicRawNs();
+
+            if(i >= nextSample) recordSample(nowNs);
+        }
+        while(nowNs < endNs);
+    }
+
+    if(result.perfOpened)
+    {
+        perf.stop();
+        result.perf = perf.read();
+    }
+
+    consumeKernelState(state);
+
+    result.elapsedNs  = nowNs - startNs;
+    result.iterations = i;
+
+    // Sampled just after the window, while the core is still at its loaded clock
+    result.lastCpu = sched_getcpu();
+    result.cpuMhz  = readCpuFrequencyMhz(result.lastCpu);
+}
+
+/**
+ * Turn a worker's raw progress samples into the detail-log lines, mapping raw
+ * monotonic stamps onto wall-clock time through the anchor taken at window start.
+ * Runs after the window in one pass: one stream in the cached user locale, the line
+ * prefix built once and the date text redone only when the second changes.
+ */
+static void renderProgress(std::ostringstream &buffer, const WorkerResult &result,
+                           const n_type cycle, const n_type cycles,
+                           const unsigned index, const bool multiThreaded,
+                           const std::chrono::system_clock::time_point anchorSys, const std::uint64_t anchorRawNs)
+{
+    std::ostringstream lines;
+    lines.imbue(userLocale());
+    lines << "Cycle " << cycle << " of " << cycles;
+
+    if(multiThreaded) lines << " Thread " << index;
+
+    lines << " Iteration ";
+
+    const std::string prefix = lines.str();
+    std::time_t shownSecond = -1;
+    char dateText[32] = "";
+
+    lines.str("");
+
+    for(const ProgressSample &sample : result.samples)
+    {
+        const auto offset = std::chrono::nanoseconds(static_cast<std::int64_t>(sample.rawNs - anchorRawNs));
+        const auto progressTp = anchorSys + std::chrono::duration_cast<std::chrono::system_clock::duration>(offset);
+        const std::time_t second = std::chrono::system_clock::to_time_t(progressTp);
+
+        if(second != shownSecond)
+        {
+            std::tm localTm{};
+            localtime_r(&second, &localTm);
+            std::strftime(dateText, sizeof(dateText), "%Y-%m-%d %H:%M:%S", &localTm);
+            shownSecond = second;
+        }
+
+        lines << prefix << sample.iteration << " " << dateText << "\n";
+    }
+
+    buffer << lines.str();
+
+    if(result.droppedSamples)
+    {
+        if(multiThreaded) buffer << "Thread " << index << " ";
+        buffer << formatWithCommas(result.droppedSamples) << " progress samples dropped (sample ring or arena full)\n";
+    }
+}
+
+/**
+ * A NUMA node and the CPUs on it this process may use. id is -1 when the host
+ * exposes no NUMA topology, in which case memory is never bound.
+ */
+struct NumaNode
+{
+    int id = -1;
+    std::vector<int> cpus;
+};
+
+/**
+ * Parse a kernel cpulist such as "0-3,8,10-11".
+ */
+static std::vector<int> parseCpuList(const std::string &text)
+{
+    std::vector<int> cpus;
+    std::istringstream in(text);
+    std::string range;
+
+    while(std::getline(in, range, ','))
+    {
+        if(range.empty() || range == "\n") continue;
+
+        const std::size_t dash = range.find('-');
+        const int first = std::atoi(range.c_str());
+        const int last  = (dash == std::string::npos) ? first : std::atoi(range.c_str() + dash + 1);
+
+        for(int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+
+    return cpus;
+}
+
+/**
+ * NUMA nodes from sysfs, keeping only CPUs in our affinity mask. Memory-only nodes
+ * are kept too since they are valid remote targets.
+ */
+static std::vector<NumaNode> getNumaNodes(const std::vector<int> &allowedCpus)
+{
+    std::vector<NumaNode> nodes;
+    const fs::path nodeRoot = "/sys/devices/system/node";
+    std::error_code ec;
+
+    for(const auto &entry : fs::directory_iterator(nodeRoot, ec))
+    {
+        const std::string name = entry.path().filename().string();
+
+        if(name.rfind("node", 0) != 0 || name.size() < 5 || !std::isdigit(static_cast<unsigned char>(name[4]))) continue;
+
+        NumaNode node;
+        node.id = std::atoi(name.c_str() + 4);
+
+        std::ifstream cpuList(entry.path() / "cpulist");
+        std::string text;
+        std::getline(cpuList, text);
+
+        for(const int cpu : parseCpuList(text))
+        {
+            if(std::find(allowedCpus.begin(), allowedCpus.end(), cpu) != allowedCpus.end()) node.cpus.push_back(cpu);
+        }
+
+        nodes.push_back(node);
+    }
+
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode &a, const NumaNode &b) { return a.id < b.id; });
+
+    if(nodes.empty())
+    {
+        NumaNode flat;
+        flat.cpus = allowedCpus;
+        nodes.push_back(flat);
+    }
+
+    return nodes;
+}
+
+/**
+ * Bind a mapping to one NUMA node before it is first touched. Uses the raw mbind
+ * syscall so there is no libnuma dependency.
+ */
+static bool bindToNode(void *addr, const std::size_t length, const int node)
+{
+    constexpr int mpolBind = 2;
+    constexpr unsigned mpolMfStrict = 1u;
+    constexpr unsigned long maskBits = sizeof(unsigned long) * 8u * 16u;
+
+    if(node < 0 || static_cast<unsigned long>(node) >= maskBits) return false;
+
+    unsigned long mask[16] = {};
+    mask[node / (sizeof(unsigned long) * 8u)] |= 1ul << (node % (sizeof(unsigned long) * 8u));
+
+    return syscall(SYS_mbind, addr, length, mpolBind, mask, maskBits + 1u, mpolMfStrict) == 0;
+}
+
+/**
+ * Page size behind a memory arena: base pages only, transparent huge pages via
+ * madvise, or hugetlbfs pages of 2 MiB or 1 GiB.
+ */
+enum class PageMode
+{
+    base,
+    thp,
+    huge2m,
+    huge1g
+};
+
+static const char *pageModeName(const PageMode mode)
+{
+    switch(mode)
+    {
+        case PageMode::base:   return "4 KiB pages";
+        case PageMode::thp:    return "transparent huge pages";
+        case PageMode::huge2m: return "2 MiB hugetlb pages";
+        case PageMode::huge1g: return "1 GiB hugetlb pages";
+    }
+
+    return "";
+}
+
+/**
+ * Anonymous mapping for the memory tests, optionally bound to a NUMA node, released on
+ * destruction. Mapped once at startup and reused by every size and cycle, so neither
+ * mmap nor page faults land inside a timed pass. hugetlb pages fall back to THP when
+ * the pool is empty; THP mappings are 2 MiB aligned so the kernel can actually use them.
+ */
+class MemoryArena
+{
+public:
+    MemoryArena(const std::size_t length, const int node, const PageMode mode)
+        : mode_(mode)
+    {
+        constexpr std::size_t thpBytes = std::size_t(2) << 20;
+
+        if(mode_ == PageMode::huge2m || mode_ == PageMode::huge1g)
+        {
+            const unsigned shift = (mode_ == PageMode::huge1g) ? 30u : 21u;
+            const std::size_t page = std::size_t(1) << shift;
+
+            length_ = (length + page - 1u) & ~(page - 1u);
+            void *addr = mmap(nullptr, length_, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | static_cast<int>(shift << MAP_HUGE_SHIFT), -1, 0);
+
+            if(addr != MAP_FAILED) data_ = addr;
+            else mode_ = PageMode::thp;
+        }
+
+        if(data_ == nullptr)
+        {
+            length_ = (length + thpBytes - 1u) & ~(thpBytes - 1u);
+            const std::size_t slack = (mode_ == PageMode::thp) ? thpBytes : 0u;
+
+            void *addr = mmap(nullptr, length_ + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+            if(addr == MAP_FAILED) throw std::bad_alloc();
+
+            // Trim the slack so the arena starts on a 2 MiB boundary
+            char *start = static_cast<char *>(addr);
+            char *aligned = start;
+
+            if(slack)
+            {
+                aligned = reinterpret_cast<char *>((reinterpret_cast<std::uintptr_t>(start) + thpBytes - 1u) & ~(std::uintptr_t(thpBytes) - 1u));
+                char *end = aligned + length_;
+
+                if(aligned > start) munmap(start, static_cast<std::size_t>(aligned - start));
+                if(end < start + length_ + slack) munmap(end, static_cast<std::size_t>(start + length_ + slack - end));
+            }
+
+            data_ = aligned;
+            madvise(data_, length_, (mode_ == PageMode::thp) ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+        }
+
+        bound_ = bindToNode(data_, length_, node);
+    }
+
+    ~MemoryArena() { munmap(data_, length_); }
+
+    MemoryArena(const MemoryArena &) = delete;
+    MemoryArena &operator=(const MemoryArena &) = delete;
+
+    /**
+     * Fault every page in from the calling thread, which should be the pinned worker
+     * that owns the arena: unbound memory then lands on its node by first touch.
+     */
+    void firstTouch()
+    {
+        const std::uint64_t t0 = monotonicRawNs();
+        char *bytes = static_cast<char *>(data_);
+
+        for(std::size_t k = 0u; k < length_; k += 4096u) bytes[k] = 0;
+
+        asm volatile("" : : "r"(bytes) : "memory");
+        touchNs_ = monotonicRawNs() - t0;
+    }
+
+    /**
+     * Bytes of the arena on huge pages. THP is best effort, so it is read back from
+     * the mapping's AnonHugePages line in /proc/self/smaps.
+     */
+    std::size_t hugeBytes() const
+    {
+        if(mode_ == PageMode::huge2m || mode_ == PageMode::huge1g) return length_;
+        if(mode_ == PageMode::base) return 0u;
+
+        std::ifstream smaps("/proc/self/smaps");
+        std::string line;
+        const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(data_);
+        bool inside = false;
+        std::size_t kib = 0u;
+
+        while(std::getline(smaps, line))
+        {
+            const std::size_t dash = line.find('-');
+
+            if(dash != std::string::npos && dash > 0u && std::isxdigit(static_cast<unsigned char>(line[0])) && line.find(' ') > dash)
+            {
+                const std::uintptr_t first = std::strtoull(line.c_str(), nullptr, 16);
+                const std::uintptr_t last = std::strtoull(line.c_str() + dash + 1u, nullptr, 16);
+                inside = first < start + length_ && last > start;
+            }
+            else if(inside && line.rfind("AnonHugePages:", 0) == 0)
+            {
+                kib += std::strtoull(line.c_str() + 14, nullptr, 10);
+            }
+        }
+
+        return std::min(length_, kib << 10);
+    }
+
+    template<typename T>
+    T *as() const { return static_cast<T *>(data_); }
+
+    std::size_t length() const { return length_; }
+    bool bound() const { return bound_; }
+    PageMode pages() const { return mode_; }
+    std::uint64_t touchNs() const { return touchNs_; }
+
+private:
+    void *data_ = nullptr;
+    std::size_t length_ = 0u;
+    PageMode mode_;
+    bool bound_ = false;
+    std::uint64_t touchNs_ = 0u;
+};
+
+/**
+ * Size of the largest data/unified cache cpu0 reports, or 32 MiB if unknown.
+ */
+static std::size_t lastLevelCacheBytes()
+{
+    std::size_t largest = 0u;
+    std::error_code ec;
+
+    for(const auto &entry : fs::directory_iterator("/sys/devices/system/cpu/cpu0/cache", ec))
+    {
+        std::ifstream typeFile(entry.path() / "type");
+        std::ifstream sizeFile(entry.path() / "size");
+        std::string type, size;
+
+        if(!(typeFile >> type) || !(sizeFile >> size) || type == "Instruction") continue;
+
+        std::size_t bytes = std::strtoull(size.c_str(), nullptr, 10);
+
+        if(size.back() == 'K') bytes <<= 10;
+        else if(size.back() == 'M') bytes <<= 20;
+
+        largest = std::max(largest, bytes);
+    }
+
+    return largest ? largest : (std::size_t(32) << 20);
+}
+
+/**
+ * Working-set sizes from well inside L1 (16 KiB) up to 'maxBytes', doubling each step.
+ */
+static std::vector<std::size_t> memorySweepSizes(const std::size_t maxBytes)
+{
+    std::vector<std::size_t> sizes;
+
+    for(std::size_t bytes = std::size_t(16) << 10; bytes <= maxBytes; bytes *= 2u) sizes.push_back(bytes);
+
+    return sizes;
+}
+
+/**
+ * "16 KiB", "4 MiB" and so on for power-of-two sizes.
+ */
+static std::string formatBytes(const std::size_t bytes)
+{
+    std::ostringstream oss;
+
+    if(bytes >= (std::size_t(1) << 30) && bytes % (std::size_t(1) << 30) == 0u) oss << (bytes >> 30) << " GiB";
+    else if(bytes >= (std::size_t(1) << 20) && bytes % (std::size_t(1) << 20) == 0u) oss << (bytes >> 20) << " MiB";
+    else oss << (bytes >> 10) << " KiB";
+
+    return oss.str();
+}
+
+/**
+ * Where a memory sweep runs: the worker is pinned to a CPU of cpuNode and its
+ * buffers are bound to memNode.
+ */
+struct MemoryPlacement
+{
+    int cpu = -1;
+    int cpuNode = -1;
+    int memNode = -1;
+};
+
+/**
+ * Memory tests in report order; the last one is the latency test.
+ */
+static const char *const memoryTests[] = {"copy", "scale", "add", "triad", "latency"};
+static constexpr unsigned memoryTestCount = 5u;
+static constexpr unsigned memoryLatencyTest = 4u;
+
+/**
+ * One measurement of the memory mode. value is GB/s for the STREAM tests and
+ * ns/access for the latency test.
+ */
+struct MemoryResult
+{
+    unsigned test;
+    std::size_t bytes;
+    MemoryPlacement placement;
+    double value;
+    bool bound;
+};
+
+/**
+ * Running totals per (placement, size) across cycles, for the final summary.
+ */
+struct MemorySummary
+{
+    double sum[memoryTestCount] = {};
+    n_type count[memoryTestCount] = {};
+};
+
+using MemorySummaryKey = std::tuple<int, int, std::size_t>;
+
+/**
+ * Local placement for every node that has CPUs, plus one remote placement per node
+ * (memory on the next node) when there is more than one node.
+ */
+static std::vector<MemoryPlacement> memoryPlacements(const std::vector<NumaNode> &nodes)
+{
+    std::vector<MemoryPlacement> placements;
+
+    for(std::size_t n = 0u; n < nodes.size(); ++n)
+    {
+        if(nodes[n].cpus.empty()) continue;
+
+        MemoryPlacement local;
+        local.cpu = nodes[n].cpus.front();
+        local.cpuNode = nodes[n].id;
+        local.memNode = nodes[n].id;
+        placements.push_back(local);
+
+        if(nodes.size() > 1u)
+        {
+            MemoryPlacement remote = local;
+            remote.memNode = nodes[(n + 1u) % nodes.size()].id;
+            placements.push_back(remote);
+        }
+    }
+
+    return placements;
+}
+
+/**
+ * Best-of time per call of 'pass', in ns. Calls are grouped so each timed sample
+ * lasts at least ~50us, and samples repeat until 'budgetNs' is used up.
+ */
+template<typename Pass>
+static double bestPassNs(Pass &&pass, const std::uint64_t budgetNs)
+{
+    n_type reps = 1u;
+
+    for(;;)
+    {
+        const std::uint64_t t0 = monotonicRawNs();
+        for(n_type r = 0u; r < reps; ++r) pass();
+        if(monotonicRawNs() - t0 >= 50000u || reps >= (n_type(1) << 20)) break;
+        reps *= 2u;
+    }
+
+    double best = 1e300;
+    const std::uint64_t stopNs = monotonicRawNs() + budgetNs;
+
+    do
+    {
+        const std::uint64_t t0 = monotonicRawNs();
+        for(n_type r = 0u; r < reps; ++r) pass();
+        best = std::min(best, static_cast<double>(monotonicRawNs() - t0) / reps);
+    }
+    while(monotonicRawNs() < stopNs);
+
+    return best;
+}
+
+/**
+ * STREAM copy/scale/add/triad plus a pointer-chase latency test at every size,
+ * run on the calling thread (already pinned per 'placement') inside its arena.
+ */
+static void runMemorySweep(const MemoryPlacement &placement, MemoryArena &arena, const std::vector<std::size_t> &sizes,
+                           const std::uint64_t testNs, std::vector<MemoryResult> &results)
+{
+    for(const std::size_t bytes : sizes)
+    {
+        // STREAM: three equal double arrays making up the working set
+        {
+            const std::size_t n = bytes / 3u / sizeof(double);
+            double *a = arena.as<double>();
+            double *b = a + n;
+            double *c = b + n;
+            constexpr double scalar = 3.0;
+
+            for(std::size_t j = 0u; j < n; ++j) { a[j] = 1.0; b[j] = 2.0; c[j] = 0.0; }
+
+            const auto clobber = [&]() { asm volatile("" : : "r"(a), "r"(b), "r"(c) : "memory"); };
+            const double arrayBytes = static_cast<double>(n * sizeof(double));
+
+            const double copyNs  = bestPassNs([&]() { for(std::size_t j = 0u; j < n; ++j) c[j] = a[j]; clobber(); }, testNs);
+            const double scaleNs = bestPassNs([&]() { for(std::size_t j = 0u; j < n; ++j) b[j] = scalar * c[j]; clobber(); }, testNs);
+            const double addNs   = bestPassNs([&]() { for(std::size_t j = 0u; j < n; ++j) c[j] = a[j] + b[j]; clobber(); }, testNs);
+            const double triadNs = bestPassNs([&]() { for(std::size_t j = 0u; j < n; ++j) a[j] = b[j] + scalar * c[j]; clobber(); }, testNs);
+
+            // Bytes per pass follow the STREAM convention (2, 2, 3 and 3 arrays)
+            results.push_back({0u, bytes, placement, 2.0 * arrayBytes / copyNs,  arena.bound()});
+            results.push_back({1u, bytes, placement, 2.0 * arrayBytes / scaleNs, arena.bound()});
+            results.push_back({2u, bytes, placement, 3.0 * arrayBytes / addNs,   arena.bound()});
+            results.push_back({3u, bytes, placement, 3.0 * arrayBytes / triadNs, arena.bound()});
+        }
+
+        // Latency: one dependent load per 64-byte line, lines visited in random order
+        {
+            constexpr std::size_t lineWords = 64u / sizeof(std::uint64_t);
+            const std::size_t lines = bytes / 64u;
+            std::uint64_t *words = arena.as<std::uint64_t>();
+            std::vector<std::uint64_t> order(lines);
+            std::uint64_t seed = 0x1A7E2C1ull ^ bytes;
+
+            for(std::size_t k = 0u; k < lines; ++k) order[k] = k;
+
+            for(std::size_t k = lines - 1u; k > 0u; --k)
+            {
+                std::swap(order[k], order[static_cast<std::size_t>(nextRandom(seed) % (k + 1u))]);
+            }
+
+            for(std::size_t k = 0u; k < lines; ++k)
+            {
+                words[order[k] * lineWords] = order[(k + 1u) % lines] * lineWords;
+            }
+
+            constexpr n_type steps = 4096u;
+            std::uint64_t link = order[0] * lineWords;
+
+            const double passNs = bestPassNs([&]()
+            {
+                for(n_type s = 0u; s < steps; ++s) link = words[link];
+                keepValue(link);
+            }, testNs);
+
+            results.push_back({memoryLatencyTest, bytes, placement, passNs / steps, arena.bound()});
+        }
+    }
+}
+
+/**
+ * Spin-wait hint: PAUSE on x86, YIELD on aarch64, nothing elsewhere.
+ */
+static inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+/**
+ * One-way core-to-core latency in ns: a single cache line bounces between a thread
+ * pinned to 'cpuA' (stores odd values) and one pinned to 'cpuB' (answers with the
+ * next even value). Half the round trip, median of 'batches' timed batches after
+ * one untimed warm-up batch.
+ */
+static double pingPongNs(const int cpuA, const int cpuB, const n_type roundTrips, const unsigned batches = 5u)
+{
+    struct alignas(cacheLineBytes) Line
+    {
+        std::atomic<std::uint64_t> value{0u};
+    };
+
+    Line line;
+    std::vector<double> samples(batches);
+    const std::uint64_t total = static_cast<std::uint64_t>(roundTrips) * (batches + 1u);
+
+    // Long spins back off to the scheduler so a shared core still makes progress
+    const auto waitFor = [&line](const std::uint64_t expected)
+    {
+        for(unsigned spins = 1u; line.value.load(std::memory_order_acquire) != expected; ++spins)
+        {
+            if(spins % 65536u == 0u) std::this_thread::yield();
+            else cpuRelax();
+        }
+    };
+
+    std::thread pong([&]()
+    {
+        pinThreadToCpu(cpuB);
+
+        for(std::uint64_t k = 0u; k < total; ++k)
+        {
+            waitFor(2u * k + 1u);
+            line.value.store(2u * k + 2u, std::memory_order_release);
+        }
+    });
+
+    std::thread ping([&]()
+    {
+        pinThreadToCpu(cpuA);
+        std::uint64_t k = 0u;
+
+        for(unsigned b = 0u; b <= batches; ++b)
+        {
+            const std::uint64_t t0 = monotonicRawNs();
+
+            for(n_type r = 0u; r < roundTrips; ++r, ++k)
+            {
+                line.value.store(2u * k + 1u, std::memory_order_release);
+                waitFor(2u * k + 2u);
+            }
+
+            if(b > 0u) samples[b - 1u] = static_cast<double>(monotonicRawNs() - t0) / roundTrips / 2.0;
+        }
+    });
+
+    ping.join();
+    pong.join();
+
+    std::sort(samples.begin(), samples.end());
+
+    return samples[samples.size() / 2u];
+}
+
+/**
+ * Symmetric one-way latency matrix for 'cpus', every unordered pair measured once.
+ */
+static std::vector<std::vector<double>> measureCoreLatency(const std::vector<int> &cpus, const n_type roundTrips)
+{
+    std::vector<std::vector<double>> matrix(cpus.size(), std::vector<double>(cpus.size(), 0.0));
+
+    for(std::size_t a = 0u; a < cpus.size(); ++a)
+    {
+        for(std::size_t b = a + 1u; b < cpus.size(); ++b)
+        {
+            matrix[a][b] = matrix[b][a] = pingPongNs(cpus[a], cpus[b], roundTrips);
+        }
+    }
+
+    return matrix;
+}
+
+/**
+ * Distribution of per-cycle ops/sec. Outliers are cycles whose robust z-score
+ * (distance from the median in units of 1.4826 * MAD) exceeds 3.5.
+ */
+struct CycleStats
+{
+    std::size_t count = 0u;
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double median = 0.0;
+    double p1 = 0.0;
+    double p99 = 0.0;
+    double stddev = 0.0;
+    double cv = 0.0;
+    std::vector<std::size_t> outliers;
+};
+
+/**
+ * Percentile of already sorted values, linearly interpolated between ranks.
+ */
+static double percentileSorted(const std::vector<double> &sorted, const double pct)
+{
+    if(sorted.empty()) return 0.0;
+
+    const double rank = pct / 100.0 * static_cast<double>(sorted.size() - 1u);
+    const std::size_t lower = static_cast<std::size_t>(rank);
+    const std::size_t upper = std::min(lower + 1u, sorted.size() - 1u);
+
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * (rank - static_cast<double>(lower));
+}
+
+static CycleStats computeCycleStats(const std::vector<double> &values)
+{
+    CycleStats stats;
+    stats.count = values.size();
+
+    if(values.empty()) return stats;
+
+    std::vector<double> sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0.0;
+    for(const double v : values) sum += v;
+
+    stats.min    = sorted.front();
+    stats.max    = sorted.back();
+    stats.mean   = sum / static_cast<double>(values.size());
+    stats.median = percentileSorted(sorted, 50.0);
+    stats.p1     = percentileSorted(sorted, 1.0);
+    stats.p99    = percentileSorted(sorted, 99.0);
+
+    // Sample standard deviation (n - 1)
+    double squares = 0.0;
+    for(const double v : values) squares += (v - stats.mean) * (v - stats.mean);
+
+    stats.stddev = (values.size() > 1u) ? std::sqrt(squares / static_cast<double>(values.size() - 1u)) : 0.0;
+    stats.cv     = (stats.mean > 0.0) ? stats.stddev / stats.mean : 0.0;
+
+    std::vector<double> deviations;
+    deviations.reserve(values.size());
+    for(const double v : values) deviations.push_back(std::fabs(v - stats.median));
+
+    std::sort(deviations.begin(), deviations.end());
+    const double mad = percentileSorted(deviations, 50.0) * 1.4826;
+
+    for(std::size_t k = 0u; mad > 0.0 && k < values.size(); ++k)
+    {
+        if(std::fabs(values[k] - stats.median) / mad > 3.5) stats.outliers.push_back(k);
+    }
+
+    return stats;
+}
+
+/**
+ * Two-sided 95% Student t critical value for 'df' degrees of freedom.
+ */
+static double studentT95(const std::size_t df)
+{
+    static const double table[] =
+    {
+        0.0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+
+    if(df == 0u) return 0.0;
+    if(df <= 30u) return table[df];
+
+    // Cornish-Fisher expansion around z = 1.96; within 0.001 of the exact value past df 30
+    const double z = 1.959964;
+    const double d = static_cast<double>(df);
+    return z + (z * z * z + z) / (4.0 * d) + (5.0 * std::pow(z, 5) + 16.0 * z * z * z + 3.0 * z) / (96.0 * d * d);
+}
+
+/**
+ * Half-width of the 95% confidence interval of the mean, as a fraction of the mean;
+ * -1 when there is no interval (fewer than 2 cycles or no positive mean).
+ */
+static double relativeHalfWidth95(const CycleStats &stats)
+{
+    if(stats.count < 2u || stats.mean <= 0.0) return -1.0;
+
+    return studentT95(stats.count - 1u) * stats.stddev / std::sqrt(static_cast<double>(stats.count)) / stats.mean;
+}
+
+/**
+ * Welch's t-test of 'candidate' against 'reference'. 'delta' and 'halfWidth' (the
+ * 95% CI of the difference) are fractions of the reference mean.
+ */
+struct EngineComparison
+{
+    bool valid = false;
+    double delta = 0.0;
+    double halfWidth = 0.0;
+    double t = 0.0;
+    double df = 0.0;
+    bool significant = false;
+};
+
+static EngineComparison welchCompare(const CycleStats &reference, const CycleStats &candidate)
+{
+    EngineComparison result;
+
+    if(reference.count < 2u || candidate.count < 2u || reference.mean <= 0.0) return result;
+
+    const double varRef  = reference.stddev * reference.stddev / static_cast<double>(reference.count);
+    const double varCand = candidate.stddev * candidate.stddev / static_cast<double>(candidate.count);
+    const double se = std::sqrt(varRef + varCand);
+
+    result.valid = true;
+    result.delta = (candidate.mean - reference.mean) / reference.mean;
+
+    if(se <= 0.0) return result;
+
+    // Welch-Satterthwaite degrees of freedom, rounded down for the critical value
+    result.df = (varRef + varCand) * (varRef + varCand)
+              / (varRef * varRef / static_cast<double>(reference.count - 1u)
+                 + varCand * varCand / static_cast<double>(candidate.count - 1u));
+
+    const double critical = studentT95(std::max<std::size_t>(static_cast<std::size_t>(result.df), 1u));
+
+    result.t = (candidate.mean - reference.mean) / se;
+    result.halfWidth = critical * se / reference.mean;
+    result.significant = std::fabs(result.t) > critical;
+
+    return result;
+}
+
+/**
+ * Machine-readable output formats for --format.
+ */
+enum class ResultFormat
+{
+    none,
+    json,
+    csv,
+    ndjson
+};
+
+/**
+ * One machine-readable record. 'record' is "cycle" (one per worker per cycle),
+ * "memory" (one per memory measurement), "c2c" (one per CPU pair and cycle),
+ * "summary" (one per run, or per thread count with --sweep), "scaling" (one per
+ * --sweep thread count) or "baseline" (one per --compare-baseline summary). Fields that
+ * do not apply to a record type are left at their defaults and omitted from JSON.
+ */
+struct ResultRecord
+{
+    const char *record = "cycle";
+    n_type cycle = 0u;
+    int thread = -1;
+    unsigned threads = 0u;
+    int cpu = -1;
+    int peerCpu = -1;
+    std::string kernel;
+    const char *engine = "";
+    std::string variant;
+    const char *isa = "";
+    std::uint64_t startNs = 0u;
+    std::uint64_t endNs = 0u;
+    sum_type iterations = 0u;
+    double opsPerSec = 0.0;
+    double cpuMhz = 0.0;
+    const char *test = "";
+    std::size_t bytes = 0u;
+    int cpuNode = -1;
+    int memNode = -1;
+    double value = 0.0;
+    const char *unit = "";
+    const CycleStats *stats = nullptr;
+    double ciHalfWidth = 0.0;   // < 0: no interval, left empty
+    const PerfCounts *perf = nullptr;
+    double speedup = 0.0;
+    double efficiency = 0.0;
+    const char *verdict = "";
+    const Telemetry *telemetry = nullptr;
+    std::string node;
+    std::string workload;
+    const CgroupThrottle *cgroup = nullptr;
+};
+
+/**
+ * RFC 4180 field: quoted, with quotes doubled, only when it holds a comma, quote or
+ * line break.
+ */
+static std::string csvField(const std::string &text)
+{
+    if(text.find_first_of(",\"\r\n") == std::string::npos) return text;
+
+    std::string out = "\"";
+
+    for(const char ch : text)
+    {
+        if(ch == '"') out += '"';
+        out += ch;
+    }
+
+    return out + "\"";
+}
+
+static std::string jsonEscape(const std::string &text)
+{
+    std::string out;
+
+    for(const char ch : text)
+    {
+        if(ch == '"' || ch == '\\') { out += '\\'; out += ch; }
+        else if(static_cast<unsigned char>(ch) < 0x20u) { char esc[8]; std::snprintf(esc, sizeof(esc), "\\u%04x", ch); out += esc; }
+        else out += ch;
+    }
+
+    return out;
+}
+
+/**
+ * Locale-independent decimal text; the classic locale never groups digits.
+ */
+static std::string fixedText(const double value, const int precision)
+{
+    std::ostringstream oss;
+    oss.imbue(std::locale::classic());
+    oss << std::fixed << std::setprecision(precision) << value;
+    return oss.str();
+}
+
+/**
+ * Tab-separated latency matrix in ns, CPU numbers along both axes, '-' on the diagonal.
+ */
+static std::string renderLatencyMatrix(const std::vector<int> &cpus, const std::vector<std::vector<double>> &matrix)
+{
+    std::ostringstream out;
+    out << "CPU";
+
+    for(const int cpu : cpus) out << "\t" << cpu;
+
+    out << "\n";
+
+    for(std::size_t a = 0u; a < cpus.size(); ++a)
+    {
+        out << cpus[a];
+
+        for(std::size_t b = 0u; b < cpus.size(); ++b) out << "\t" << ((a == b) ? std::string("-") : fixedText(matrix[a][b], 1));
+
+        out << "\n";
+    }
+
+    return out.str();
+}
+
+/**
+ * Renders ResultRecords as JSON (one array per run), CSV or NDJSON. Plain integers
+ * and '.' decimals only, so output never depends on the locale.
+ */
+class ResultFormatter
+{
+public:
+    ResultFormatter(const ResultFormat format, std::string host)
+        : format_(format), host_(std::move(host))
+    {
+    }
+
+    static const char *extension(const ResultFormat format)
+    {
+        switch(format)
+        {
+            case ResultFormat::json:   return "json";
+            case ResultFormat::csv:    return "csv";
+            case ResultFormat::ndjson: return "ndjson";
+            default:                   return "";
+        }
+    }
+
+    std::string header() const
+    {
+        if(format_ == ResultFormat::json) return "[\n";
+        if(format_ == ResultFormat::csv)
+        {
+            return "record,host,cycle,thread,threads,cpu,kernel,start_ns,end_ns,iterations,ops_per_sec,cpu_mhz,"
+                   "test,bytes,cpu_node,mem_node,value,unit,min,max,median,p1,p99,stddev,cv,outliers,ci95,"
+                   "cycles,instructions,llc_misses,branch_misses,context_switches,engine,variant,isa,peer_cpu,speedup,efficiency_pct,verdict,"
+                   "ghz,package_watts,ops_per_joule,max_temp_c,throttle_events,node,workload,cg_periods,cg_throttled,cg_throttled_ms\n";
+        }
+        return "";
+    }
+
+    std::string footer() const
+    {
+        return (format_ == ResultFormat::json) ? "\n]\n" : "";
+    }
+
+    std::string format(const ResultRecord &r)
+    {
+        std::ostringstream out;
+        out.imbue(std::locale::classic());
+
+        if(format_ == ResultFormat::csv)
+        {
+            out << r.record << "," << csvField(host_) << "," << r.cycle << "," << r.thread << "," << r.threads << "," << r.cpu << ","
+                << csvField(r.kernel) << "," << r.startNs << "," << r.endNs << "," << sumToString(r.iterations) << ","
+                << fixedText(r.opsPerSec, 1) << "," << fixedText(r.cpuMhz, 1) << ","
+                << r.test << "," << r.bytes << "," << r.cpuNode << "," << r.memNode << ","
+                << fixedText(r.value, 3) << "," << r.unit;
+
+            if(r.stats)
+            {
+                out << "," << fixedText(r.stats->min, 1) << "," << fixedText(r.stats->max, 1)
+                    << "," << fixedText(r.stats->median, 1) << "," << fixedText(r.stats->p1, 1)
+                    << "," << fixedText(r.stats->p99, 1) << "," << fixedText(r.stats->stddev, 1)
+                    << "," << fixedText(r.stats->cv, 6) << "," << r.stats->outliers.size()
+                    << "," << (r.ciHalfWidth >= 0.0 ? fixedText(r.ciHalfWidth, 6) : "");
+            }
+            else
+            {
+                out << ",,,,,,,,,";
+            }
+
+            if(r.perf && r.perf->hasHardware)
+            {
+                out << "," << r.perf->cycles << "," << r.perf->instructions
+                    << "," << r.perf->llcMisses << "," << r.perf->branchMisses;
+            }
+            else
+            {
+                out << ",,,,";
+            }
+
+            out << ",";
+            if(r.perf && r.perf->hasContextSwitches) out << r.perf->contextSwitches;
+
+            out << "," << r.engine << "," << csvField(r.variant) << "," << r.isa << "," << r.peerCpu << ",";
+            if(r.speedup > 0.0) out << fixedText(r.speedup, 3) << "," << fixedText(r.efficiency, 1);
+            else out << ",";
+
+            out << "," << r.verdict;
+
+            const Telemetry *t = r.telemetry;
+            out << "," << ((t && t->hasFrequency) ? fixedText(t->ghz, 3) : "")
+                << "," << ((t && t->hasEnergy) ? fixedText(t->watts, 3) : "")
+                << "," << ((t && t->hasEnergy) ? fixedText(t->opsPerJoule, 1) : "")
+                << "," << ((t && t->hasTemperature) ? fixedText(t->maxTempC, 1) : "")
+                << "," << ((t && t->hasThrottle) ? std::to_string(t->throttleEvents) : "")
+                << "," << csvField(r.node) << "," << csvField(r.workload);
+
+            const CgroupThrottle *cg = r.cgroup;
+            if(cg && cg->valid) out << "," << cg->periods << "," << cg->throttled << "," << fixedText(cg->throttledMs, 3) << "\n";
+            else out << ",,,\n";
+
+            return out.str();
+        }
+
+        if(format_ == ResultFormat::json && records_++ > 0u) out << ",\n";
+
+        out << "{\"record\":\"" << r.record << "\",\"host\":\"" << jsonEscape(host_) << "\"";
+
+        if(!r.node.empty()) out << ",\"node\":\"" << jsonEscape(r.node) << "\"";
+        if(!r.workload.empty()) out << ",\"workload\":\"" << jsonEscape(r.workload) << "\"";
+
+        if(r.cycle) out << ",\"cycle\":" << r.cycle;
+        if(r.thread >= 0) out << ",\"thread\":" << r.thread;
+        if(r.threads) out << ",\"threads\":" << r.threads;
+        if(r.cpu >= 0) out << ",\"cpu\":" << r.cpu;
+        if(!r.kernel.empty()) out << ",\"kernel\":\"" << jsonEscape(r.kernel) << "\"";
+        if(*r.engine) out << ",\"engine\":\"" << r.engine << "\"";
+        if(!r.variant.empty()) out << ",\"variant\":\"" << r.variant << "\"";
+        if(*r.isa) out << ",\"isa\":\"" << r.isa << "\"";
+        if(r.startNs) out << ",\"start_ns\":" << r.startNs << ",\"end_ns\":" << r.endNs;
+
+        if(*r.test)
+        {
+            out << ",\"test\":\"" << r.test << "\",\"bytes\":" << r.bytes
+                << ",\"cpu_node\":" << r.cpuNode << ",\"mem_node\":" << r.memNode
+                << ",\"value\":" << fixedText(r.value, 3) << ",\"unit\":\"" << r.unit << "\"";
+        }
+        else if(r.peerCpu >= 0)
+        {
+            out << ",\"peer_cpu\":" << r.peerCpu << ",\"value\":" << fixedText(r.value, 3) << ",\"unit\":\"" << r.unit << "\"";
+        }
+        else
+        {
+            out << ",\"iterations\":" << sumToString(r.iterations) << ",\"ops_per_sec\":" << fixedText(r.opsPerSec, 1);
+
+            if(*r.unit) out << ",\"value\":" << fixedText(r.value, 6) << ",\"unit\":\"" << r.unit << "\"";
+            if(r.speedup > 0.0) out << ",\"speedup\":" << fixedText(r.speedup, 3) << ",\"efficiency_pct\":" << fixedText(r.efficiency, 1);
+            if(*r.verdict) out << ",\"verdict\":\"" << r.verdict << "\"";
+        }
+
+        if(r.cpuMhz > 0.0) out << ",\"cpu_mhz\":" << fixedText(r.cpuMhz, 1);
+
+        if(r.stats)
+        {
+            out << ",\"min\":" << fixedText(r.stats->min, 1) << ",\"max\":" << fixedText(r.stats->max, 1)
+                << ",\"mean\":" << fixedText(r.stats->mean, 1) << ",\"median\":" << fixedText(r.stats->median, 1)
+                << ",\"p1\":" << fixedText(r.stats->p1, 1) << ",\"p99\":" << fixedText(r.stats->p99, 1)
+                << ",\"stddev\":" << fixedText(r.stats->stddev, 1) << ",\"cv\":" << fixedText(r.stats->cv, 6)
+                << (r.ciHalfWidth >= 0.0 ? ",\"ci95\":" + fixedText(r.ciHalfWidth, 6) : std::string()) << ",\"outlier_cycles\":[";
+
+            for(std::size_t k = 0u; k < r.stats->outliers.size(); ++k) out << (k ? "," : "") << (r.stats->outliers[k] + 1u);
+
+            out << "]";
+        }
+
+        if(r.perf && r.perf->hasHardware)
+        {
+            out << ",\"cycles\":" << r.perf->cycles << ",\"instructions\":" << r.perf->instructions
+                << ",\"llc_misses\":" << r.perf->llcMisses << ",\"branch_misses\":" << r.perf->branchMisses;
+        }
+
+        if(r.perf && r.perf->hasContextSwitches) out << ",\"context_switches\":" << r.perf->contextSwitches;
+
+        if(r.telemetry)
+        {
+            const Telemetry &t = *r.telemetry;
+
+            if(t.hasFrequency) out << ",\"ghz\":" << fixedText(t.ghz, 3);
+            if(t.hasEnergy) out << ",\"package_watts\":" << fixedText(t.watts, 3) << ",\"ops_per_joule\":" << fixedText(t.opsPerJoule, 1);
+            if(t.hasTemperature) out << ",\"max_temp_c\":" << fixedText(t.maxTempC, 1);
+            if(t.hasThrottle) out << ",\"throttle_events\":" << t.throttleEvents;
+        }
+
+        if(r.cgroup && r.cgroup->valid)
+        {
+            out << ",\"cg_periods\":" << r.cgroup->periods << ",\"cg_throttled\":" << r.cgroup->throttled
+                << ",\"cg_throttled_ms\":" << fixedText(r.cgroup->throttledMs, 3);
+        }
+
+        out << "}";
+
+        if(format_ == ResultFormat::ndjson) out << "\n";
+
+        return out.str();
+    }
+
+private:
+    ResultFormat format_;
+    std::string host_;
+    n_type records_ = 0u;
+};
+
+/**
+ * Nanoseconds since the Unix epoch.
+ */
+static std::uint64_t epochNs(const std::chrono::system_clock::time_point tp)
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count());
+}
+
+static std::string hostName()
+{
+    char name[256] = {};
+
+    if(gethostname(name, sizeof(name) - 1u) != 0) return "unknown";
+
+    return name;
+}
+
+/**
+ * One line of derived counter figures for the detail log.
+ */
+static std::string renderPerfCounts(const PerfCounts &counts, const n_type iterations)
+{
+    const double ops = static_cast<double>(std::max<n_type>(iterations, 1u));
+    std::ostringstream out;
+
+    out << "Perf";
+
+    if(counts.hasHardware)
+    {
+        const double ipc = counts.cycles ? static_cast<double>(counts.instructions) / static_cast<double>(counts.cycles) : 0.0;
+
+        out << " IPC " << fixedText(ipc, 2)
+            << " Cycles/op " << fixedText(static_cast<double>(counts.cycles) / ops, 3)
+            << " Instructions/op " << fixedText(static_cast<double>(counts.instructions) / ops, 3)
+            << " LLC-misses/op " << fixedText(static_cast<double>(counts.llcMisses) / ops, 6)
+            << " Branch-misses/op " << fixedText(static_cast<double>(counts.branchMisses) / ops, 6);
+    }
+    else
+    {
+        out << " hardware counters unavailable";
+    }
+
+    if(counts.hasContextSwitches) out << " Context switches " << counts.contextSwitches;
+
+    return out.str();
+}
+
+/**
+ * Human-readable summary lines for the console and Iteration.txt.
+ */
+static std::string renderCycleStats(const CycleStats &stats, const std::vector<double> &values)
+{
+    const auto ops = [](const double v) { return formatWithCommas(static_cast<n_type>(v)); };
+
+    std::ostringstream out;
+
+    out << "Min: " << ops(stats.min) << " Max: " << ops(stats.max)
+        << " Mean: " << ops(stats.mean) << " Median: " << ops(stats.median) << "\n"
+        << "P1: " << ops(stats.p1) << " P99: " << ops(stats.p99)
+        << " Stddev: " << ops(stats.stddev)
+        << " CV: " << fixedText(stats.cv * 100.0, 2) << "%\n"
+        << "95% CI: ";
+
+    const double halfWidth = relativeHalfWidth95(stats);
+
+    if(halfWidth >= 0.0) out << "+/- " << fixedText(halfWidth * 100.0, 2) << "% of mean\n";
+    else out << "n/a (needs 2+ cycles)\n";
+
+    out << "Outlier cycles: ";
+
+    if(stats.outliers.empty()) out << "none";
+
+    for(std::size_t k = 0u; k < stats.outliers.size(); ++k)
+    {
+        const std::size_t index = stats.outliers[k];
+        out << (k ? ", " : "") << (index + 1u) << " (" << ops(values[index]) << ")";
+    }
+
+    out << "\n";
+
+    return out.str();
+}
+
+/**
+ * One --sweep thread count. Speedup is against the first point's per-thread rate
+ * (the 1-thread rate when the sweep starts at 1); efficiency is speedup / threads.
+ */
+struct ScalingPoint
+{
+    unsigned threads = 0u;
+    double opsPerSec = 0.0;
+    double cv = 0.0;
+    double speedup = 0.0;
+    double efficiency = 0.0;
+};
+
+static void computeScaling(std::vector<ScalingPoint> &points)
+{
+    if(points.empty() || !(points[0].opsPerSec > 0.0)) return;
+
+    const double basePerThread = points[0].opsPerSec / points[0].threads;
+
+    for(ScalingPoint &point : points)
+    {
+        point.speedup = point.opsPerSec / basePerThread;
+        point.efficiency = point.speedup / point.threads * 100.0;
+    }
+}
+
+static std::string renderScalingTable(const std::vector<ScalingPoint> &points)
+{
+    std::ostringstream out;
+    out << "Scaling across thread counts (speedup vs " << (points.empty() ? 1u : points[0].threads)
+        << " thread(s), efficiency = speedup / threads)\n"
+        << "Threads\tOps/sec\tPer-thread\tSpeedup\tEfficiency\tCV\n";
+
+    for(const ScalingPoint &point : points)
+    {
+        out << point.threads << "\t" << formatWithCommas(static_cast<n_type>(point.opsPerSec))
+            << "\t" << formatWithCommas(static_cast<n_type>(point.opsPerSec / point.threads))
+            << "\t" << fixedText(point.speedup, 2) << "x\t" << fixedText(point.efficiency, 1) << "%"
+            << "\t" << fixedText(point.cv * 100.0, 2) << "%\n";
+    }
+
+    return out.str();
+}
+
+/**
+ * One run in the baseline history. Records are a fixed 256 bytes so the file is
+ * appended and scanned without parsing; 'key' hashes host, CPU model, kernel and
+ * thread count, and the strings are kept to rule out hash collisions.
+ */
+struct BaselineEntry
+{
+    std::uint64_t key;
+    std::uint64_t timeNs;
+    std::uint64_t previous;
+    std::uint32_t threads;
+    std::uint32_t cycles;
+    std::uint32_t windowMs;
+    std::uint32_t warmupMs;
+    double mean;
+    double median;
+    double stddev;
+    double min;
+    double max;
+    char engine[16];
+    char host[64];
+    char cpuModel[64];
+    char kernel[32];
+};
+
+static_assert(sizeof(BaselineEntry) == 256u, "baseline records have a fixed on-disk size");
+
+/**
+ * One key of the baseline index: record number of the newest run stored under it.
+ */
+struct BaselineIndexEntry
+{
+    std::uint64_t key;
+    std::uint64_t newest;
+};
+
+// previous/newest value for "no such record", as in the detail log's index links
+static constexpr std::uint64_t baselineNoRecord = ~std::uint64_t(0);
+
+// Runs per key that make up the baseline: the newest ones, so it tracks the host as it is now
+static constexpr std::size_t baselineHistory = 30u;
+
+/**
+ * Append-only binary history of run summaries ("CSBASE02" header, then records). Every
+ * record links to the previous record with the same key, and a sidecar index
+ * ("<path>.idx": "CSBIDX01", the record count it covers, then key/newest pairs) holds
+ * the newest record per key. A lookup reads the index and follows one chain back,
+ * so it costs the history it returns, not the size of the file. An index that is
+ * missing or behind the file (a crash between the two writes) is rebuilt by one scan.
+ */
+class BaselineDb
+{
+public:
+    explicit BaselineDb(fs::path path)
+        : path_(std::move(path)), indexPath_(path_.string() + ".idx")
+    {
+    }
+
+    static BaselineEntry makeEntry(const std::string &host, const std::string &cpuModel, const std::string &kernel,
+                                   const std::string &engine, const unsigned threads, const n_type windowMs,
+                                   const n_type warmupMs)
+    {
+        BaselineEntry entry{};
+        std::snprintf(entry.host, sizeof(entry.host), "%s", host.c_str());
+        std::snprintf(entry.cpuModel, sizeof(entry.cpuModel), "%s", cpuModel.c_str());
+        std::snprintf(entry.kernel, sizeof(entry.kernel), "%s", kernel.c_str());
+        std::snprintf(entry.engine, sizeof(entry.engine), "%s", engine.c_str());
+        entry.threads = threads;
+        entry.windowMs = static_cast<std::uint32_t>(windowMs);
+        entry.warmupMs = static_cast<std::uint32_t>(std::min<n_type>(warmupMs, 0xFFFFFFFFu));
+        entry.previous = baselineNoRecord;
+
+        // FNV-1a over the (truncated) key strings, the thread count and the window settings
+        std::uint64_t hash = 14695981039346656037ull;
+        const auto mix = [&hash](const char *bytes, const std::size_t length)
+        {
+            for(std::size_t k = 0u; k < length; ++k) hash = (hash ^ static_cast<unsigned char>(bytes[k])) * 1099511628211ull;
+        };
+
+        mix(entry.host, std::strlen(entry.host) + 1u);
+        mix(entry.cpuModel, std::strlen(entry.cpuModel) + 1u);
+        mix(entry.kernel, std::strlen(entry.kernel) + 1u);
+        mix(entry.engine, std::strlen(entry.engine) + 1u);
+        mix(reinterpret_cast<const char *>(&entry.threads), sizeof(entry.threads));
+        mix(reinterpret_cast<const char *>(&entry.windowMs), sizeof(entry.windowMs));
+        mix(reinterpret_cast<const char *>(&entry.warmupMs), sizeof(entry.warmupMs));
+
+        entry.key = hash;
+
+        return entry;
+    }
+
+    /**
+     * The newest 'limit' runs stored under the key of 'probe', oldest first.
+     */
+    std::vector<BaselineEntry> lookup(const BaselineEntry &probe, const std::size_t limit)
+    {
+        std::vector<BaselineEntry> found;
+        std::ifstream in(path_, std::ios::binary);
+
+        if(!in) return found;
+        if(!readHeader(in)) return found;
+
+        std::uint64_t record = newestRecord(in, probe.key);
+        BaselineEntry entry{};
+
+        // Only the chain of this key is read; other keys sharing the hash are skipped
+        while(record != baselineNoRecord && found.size() < limit && readRecord(in, record, entry))
+        {
+            if(sameKey(entry, probe)) found.push_back(entry);
+            record = entry.previous;
+        }
+
+        std::reverse(found.begin(), found.end());
+
+        return found;
+    }
+
+    bool append(BaselineEntry entry)
+    {
+        std::error_code ec;
+        const bool fresh = !fs::exists(path_, ec) || fs::file_size(path_, ec) == 0u;
+        std::uint64_t records = 0u;
+
+        if(!fresh)
+        {
+            std::ifstream check(path_, std::ios::binary);
+            if(!readHeader(check)) return false;
+
+            entry.previous = newestRecord(check, entry.key);
+            records = recordCount();
+        }
+
+        std::ofstream out(path_, std::ios::binary | std::ios::app);
+
+        if(fresh) out.write(magic, sizeof(magic));
+
+        out.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+        out.close();
+
+        if(!out) return false;
+
+        // The record is durable first; a stale index is only ever rebuilt, never trusted
+        index_[entry.key] = records;
+        indexRecords_ = records + 1u;
+
+        return writeIndex();
+    }
+
+    const std::string &error() const { return error_; }
+
+private:
+    static constexpr char magic[8] = {'C', 'S', 'B', 'A', 'S', 'E', '0', '2'};
+    static constexpr char indexMagic[8] = {'C', 'S', 'B', 'I', 'D', 'X', '0', '1'};
+
+    bool readHeader(std::ifstream &in)
+    {
+        char header[sizeof(magic)] = {};
+
+        if(in.read(header, sizeof(header)) && std::memcmp(header, magic, sizeof(magic)) == 0) return true;
+
+        if(std::memcmp(header, magic, sizeof(magic) - 1u) == 0)
+        {
+            error_ = path_.string() + " is an older baseline database without engine and window in its key; "
+                     "move it aside to start a new history";
+        }
+        else error_ = path_.string() + " is not a baseline database";
+
+        return false;
+    }
+
+    static bool sameKey(const BaselineEntry &a, const BaselineEntry &b)
+    {
+        return a.key == b.key && a.threads == b.threads && a.windowMs == b.windowMs && a.warmupMs == b.warmupMs
+            && std::strncmp(a.host, b.host, sizeof(a.host)) == 0
+            && std::strncmp(a.cpuModel, b.cpuModel, sizeof(a.cpuModel)) == 0
+            && std::strncmp(a.kernel, b.kernel, sizeof(a.kernel)) == 0
+            && std::strncmp(a.engine, b.engine, sizeof(a.engine)) == 0;
+    }
+
+    std::uint64_t recordCount() const
+    {
+        std::error_code ec;
+        const std::uintmax_t bytes = fs::file_size(path_, ec);
+
+        return (ec || bytes < sizeof(magic)) ? 0u : (bytes - sizeof(magic)) / sizeof(BaselineEntry);
+    }
+
+    bool readRecord(std::ifstream &in, const std::uint64_t record, BaselineEntry &entry)
+    {
+        in.clear();
+        in.seekg(static_cast<std::streamoff>(sizeof(magic) + record * sizeof(BaselineEntry)));
+
+        return static_cast<bool>(in.read(reinterpret_cast<char *>(&entry), sizeof(entry)));
+    }
+
+    /**
+     * Newest record under 'key', from the index (loaded or rebuilt on first use).
+     */
+    std::uint64_t newestRecord(std::ifstream &in, const std::uint64_t key)
+    {
+        if(!indexLoaded_) loadIndex(in);
+
+        const auto it = index_.find(key);
+
+        return (it == index_.end()) ? baselineNoRecord : it->second;
+    }
+
+    void loadIndex(std::ifstream &in)
+    {
+        const std::uint64_t records = recordCount();
+        std::ifstream file(indexPath_, std::ios::binary);
+        char header[sizeof(indexMagic)] = {};
+        std::uint64_t covered = 0u;
+
+        indexLoaded_ = true;
+        index_.clear();
+
+        if(file.read(header, sizeof(header)) && std::memcmp(header, indexMagic, sizeof(indexMagic)) == 0
+           && file.read(reinterpret_cast<char *>(&covered), sizeof(covered)) && covered == records)
+        {
+            BaselineIndexEntry entry{};
+
+            while(file.read(reinterpret_cast<char *>(&entry), sizeof(entry))) index_[entry.key] = entry.newest;
+
+            indexRecords_ = records;
+            return;
+        }
+
+        // Rebuild: one pass, the last record seen per key is its newest
+        index_.clear();
+        BaselineEntry entry{};
+
+        for(std::uint64_t record = 0u; record < records && readRecord(in, record, entry); ++record) index_[entry.key] = record;
+
+        indexRecords_ = records;
+        writeIndex();
+    }
+
+    /**
+     * Rewrite the index next to the file and rename it into place.
+     */
+    bool writeIndex()
+    {
+        const std::string scratch = indexPath_.string() + ".tmp";
+        {
+            std::ofstream out(scratch, std::ios::binary | std::ios::trunc);
+
+            out.write(indexMagic, sizeof(indexMagic));
+            out.write(reinterpret_cast<const char *>(&indexRecords_), sizeof(indexRecords_));
+
+            for(const auto &item : index_)
+            {
+                const BaselineIndexEntry entry{item.first, item.second};
+                out.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+            }
+
+            if(!out) return false;
+        }
+
+        std::error_code ec;
+        fs::rename(scratch, indexPath_, ec);
+
+        return !ec;
+    }
+
+    fs::path path_;
+    fs::path indexPath_;
+    std::map<std::uint64_t, std::uint64_t> index_;
+    std::uint64_t indexRecords_ = 0u;
+    bool indexLoaded_ = false;
+    std::string error_;
+};
+
+/**
+ * This run's mean ops/sec against the stored run means: a regression (or improvement)
+ * when it falls outside the 95% prediction interval for one more run,
+ * mean +/- t(n-1) * s * sqrt(1 + 1/n). Needs 2+ stored runs.
+ */
+static EngineComparison baselineCompare(const std::vector<BaselineEntry> &history, const double currentMean)
+{
+    EngineComparison result;
+    std::vector<double> means;
+
+    for(const BaselineEntry &entry : history) means.push_back(entry.mean);
+
+    const CycleStats baseline = computeCycleStats(means);
+
+    if(baseline.count < 2u || baseline.mean <= 0.0) return result;
+
+    const double spread = baseline.stddev * std::sqrt(1.0 + 1.0 / static_cast<double>(baseline.count));
+    const double critical = studentT95(baseline.count - 1u);
+
+    result.valid = true;
+    result.delta = (currentMean - baseline.mean) / baseline.mean;
+    result.df = static_cast<double>(baseline.count - 1u);
+    result.halfWidth = critical * spread / baseline.mean;
+    result.t = (spread > 0.0) ? (currentMean - baseline.mean) / spread : 0.0;
+    result.significant = std::fabs(currentMean - baseline.mean) > critical * spread;
+
+    return result;
+}
+
+/**
+ * Single-file binary detail log, an alternative to one text file per cycle. The file
+ * is a 64-byte header followed by 64-byte records. Each cycle is an index record
+ * (cycle number, record number of the previous cycle's index record, count of the
+ * records that follow), then name records carrying the text file name it replaces,
+ * then text records carrying the detail text in 56-byte chunks. The header's record
+ * count and newest-index link are updated last, so a torn append is never visible.
+ */
+struct DetailHeader
+{
+    char magic[8];
+    std::uint32_t recordBytes;
+    std::uint32_t version;
+    std::uint64_t records;
+    std::uint64_t lastIndex;
+    std::uint64_t createdNs;
+    char reserved[24];
+};
+
+struct DetailIndex
+{
+    std::uint64_t cycle;
+    std::uint64_t previous;
+    std::uint64_t records;
+};
+
+struct DetailRecord
+{
+    std::uint16_t type;
+    std::uint16_t length;
+    std::uint32_t reserved;
+
+    union
+    {
+        char text[56];
+        DetailIndex index;
+    } body;
+};
+
+static_assert(sizeof(DetailHeader) == 64u && sizeof(DetailRecord) == 64u, "detail log layout is fixed on disk");
+
+static constexpr char detailMagic[8] = {'C', 'S', 'D', 'E', 'T', 'L', '0', '1'};
+static constexpr std::uint16_t detailIndexRecord = 1u;
+static constexpr std::uint16_t detailNameRecord  = 2u;
+static constexpr std::uint16_t detailTextRecord  = 3u;
+static constexpr std::uint64_t detailNoIndex     = ~std::uint64_t(0);
+
+/**
+ * Append-only writer for the binary detail log, backed by a shared mapping that
+ * grows by doubling (ftruncate + mremap). Trimmed to the committed size on close.
+ */
+class DetailLog
+{
+public:
+    explicit DetailLog(const fs::path &path)
+    {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+        if(fd_ < 0 || !reserve(4096u)) return;
+
+        DetailHeader &header = *static_cast<DetailHeader *>(map_);
+        std::memcpy(header.magic, detailMagic, sizeof(detailMagic));
+        header.recordBytes = sizeof(DetailRecord);
+        header.version = 1u;
+        header.lastIndex = detailNoIndex;
+        header.createdNs = epochNs(std::chrono::system_clock::now());
+    }
+
+    ~DetailLog()
+    {
+        if(map_ != nullptr)
+        {
+            const std::uint64_t used = sizeof(DetailHeader) + header().records * sizeof(DetailRecord);
+
+            msync(map_, mappedBytes_, MS_SYNC);
+            munmap(map_, mappedBytes_);
+
+            if(ftruncate(fd_, static_cast<off_t>(used)) != 0) std::perror("detail log");
+        }
+
+        if(fd_ >= 0) ::close(fd_);
+    }
+
+    DetailLog(const DetailLog &) = delete;
+    DetailLog &operator=(const DetailLog &) = delete;
+
+    bool good() const { return map_ != nullptr; }
+
+    /**
+     * One cycle's detail text under the file name it would have had in text mode.
+     */
+    bool appendCycle(const n_type cycle, const std::string &name, const std::string &text)
+    {
+        constexpr std::size_t chunk = sizeof(DetailRecord::body.text);
+        const std::uint64_t nameRecords = (name.size() + chunk - 1u) / chunk;
+        const std::uint64_t textRecords = (text.size() + chunk - 1u) / chunk;
+        const std::uint64_t first = header().records;
+
+        if(!reserve(first + 1u + nameRecords + textRecords)) return false;
+
+        DetailRecord *records = recordsAt(first);
+        records[0] = DetailRecord{};
+        records[0].type = detailIndexRecord;
+        records[0].body.index.cycle = cycle;
+        records[0].body.index.previous = header().lastIndex;
+        records[0].body.index.records = nameRecords + textRecords;
+
+        std::uint64_t next = 1u;
+        next = appendChunks(records, next, detailNameRecord, name);
+        next = appendChunks(records, next, detailTextRecord, text);
+
+        // Commit: the new records become visible only now
+        header().lastIndex = first;
+        header().records = first + next;
+
+        return true;
+    }
+
+private:
+    DetailHeader &header() { return *static_cast<DetailHeader *>(map_); }
+
+    DetailRecord *recordsAt(const std::uint64_t index)
+    {
+        return reinterpret_cast<DetailRecord *>(static_cast<char *>(map_) + sizeof(DetailHeader)) + index;
+    }
+
+    std::uint64_t appendChunks(DetailRecord *records, std::uint64_t next, const std::uint16_t type, const std::string &text)
+    {
+        constexpr std::size_t chunk = sizeof(DetailRecord::body.text);
+
+        for(std::size_t offset = 0u; offset < text.size(); offset += chunk, ++next)
+        {
+            DetailRecord &record = records[next];
+            record = DetailRecord{};
+            record.type = type;
+            record.length = static_cast<std::uint16_t>(std::min(chunk, text.size() - offset));
+            std::memcpy(record.body.text, text.data() + offset, record.length);
+        }
+
+        return next;
+    }
+
+    /**
+     * Make room for 'records' records after the header, growing the file and the mapping.
+     */
+    bool reserve(const std::uint64_t records)
+    {
+        const std::size_t needed = sizeof(DetailHeader) + records * sizeof(DetailRecord);
+
+        if(needed <= mappedBytes_) return true;
+
+        std::size_t bytes = std::max<std::size_t>(mappedBytes_ * 2u, std::size_t(1) << 20);
+        while(bytes < needed) bytes *= 2u;
+
+        if(ftruncate(fd_, static_cast<off_t>(bytes)) != 0) return false;
+
+        void *map = (map_ == nullptr)
+            ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0)
+            : mremap(map_, mappedBytes_, bytes, MREMAP_MAYMOVE);
+
+        if(map == MAP_FAILED) return false;
+
+        map_ = map;
+        mappedBytes_ = bytes;
+
+        return true;
+    }
+
+    int fd_ = -1;
+    void *map_ = nullptr;
+    std::size_t mappedBytes_ = 0u;
+};
+
+/**
+ * One cycle read back from a binary detail log.
+ */
+struct DetailCycle
+{
+    n_type cycle = 0u;
+    std::string name;
+    std::string text;
+};
+
+/**
+ * Read every committed cycle of a binary detail log, oldest first, by walking the
+ * index chain back from the header. False (with 'error' set) on a foreign or torn file.
+ */
+static bool readDetailLog(const fs::path &path, std::vector<DetailCycle> &cycles, std::string &error)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    DetailHeader header{};
+
+    if(bytes.size() < sizeof(header)) { error = "too short for a detail log"; return false; }
+
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    if(std::memcmp(header.magic, detailMagic, sizeof(detailMagic)) != 0 || header.recordBytes != sizeof(DetailRecord))
+    {
+        error = "not a binary detail log";
+        return false;
+    }
+
+    const std::uint64_t available = (bytes.size() - sizeof(header)) / sizeof(DetailRecord);
+    const std::uint64_t committed = std::min(header.records, available);
+    const auto recordAt = [&bytes](const std::uint64_t index)
+    {
+        DetailRecord record;
+        std::memcpy(&record, bytes.data() + sizeof(DetailHeader) + index * sizeof(DetailRecord), sizeof(record));
+        return record;
+    };
+
+    std::vector<std::uint64_t> indexes;
+
+    for(std::uint64_t at = header.lastIndex; at != detailNoIndex; at = recordAt(at).body.index.previous)
+    {
+        if(at >= committed || recordAt(at).type != detailIndexRecord || indexes.size() > committed)
+        {
+            error = "broken index chain at record " + std::to_string(at);
+            return false;
+        }
+
+        indexes.push_back(at);
+    }
+
+    cycles.clear();
+
+    for(auto it = indexes.rbegin(); it != indexes.rend(); ++it)
+    {
+        const DetailRecord index = recordAt(*it);
+        DetailCycle cycle;
+        cycle.cycle = index.body.index.cycle;
+
+        for(std::uint64_t k = 1u; k <= index.body.index.records && *it + k < committed; ++k)
+        {
+            const DetailRecord record = recordAt(*it + k);
+            const std::size_t length = std::min<std::size_t>(record.length, sizeof(record.body.text));
+
+            if(record.type == detailNameRecord) cycle.name.append(record.body.text, length);
+            else if(record.type == detailTextRecord) cycle.text.append(record.body.text, length);
+        }
+
+        cycles.push_back(std::move(cycle));
+    }
+
+    return true;
+}
+
+/**
+ * --export-detail: print a binary detail log in the per-cycle text layout, or with
+ * 'dir' recreate the per-cycle files there. 'onlyCycle' 0 means every cycle.
+ */
+static int exportDetailLog(const fs::path &path, const n_type onlyCycle, const fs::path &dir)
+{
+    std::vector<DetailCycle> cycles;
+    std::string error;
+
+    if(!readDetailLog(path, cycles, error))
+    {
+        std::cerr << "Cannot read " << path << ": " << error << "\n";
+        return 1;
+    }
+
+    if(!dir.empty()) fs::create_directories(dir);
+
+    std::size_t exported = 0u;
+
+    for(const DetailCycle &cycle : cycles)
+    {
+        if(onlyCycle && cycle.cycle != onlyCycle) continue;
+
+        ++exported;
+
+        if(dir.empty())
+        {
+            std::cout << cycle.text;
+            continue;
+        }
+
+        std::ofstream out(dir / cycle.name);
+
+        if(!(out << cycle.text))
+        {
+            std::cerr << "Cannot write " << (dir / cycle.name) << "\n";
+            return 1;
+        }
+    }
+
+    if(onlyCycle && exported == 0u)
+    {
+        std::cerr << "No cycle " << onlyCycle << " in " << path << "\n";
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * How much reaches the console: nothing, the end-of-run summary, one line per cycle
+ * on top of that, or every cycle's full detail (the default).
+ */
+enum class Verbosity
+{
+    none,
+    summary,
+    progress,
+    full
+};
+
+/**
+ * Console output on its own thread, so a slow terminal or pipe never stalls the
+ * measuring thread. Text up to the chosen verbosity is queued and written in order;
+ * nothing new is written while a window is open. Past 'capacityBytes' queued,
+ * progress and detail text is dropped and counted instead of waited on; summary
+ * text is always kept.
+ */
+class ConsoleWriter
+{
+public:
+    ConsoleWriter(const Verbosity verbosity, const std::size_t capacityBytes)
+        : verbosity_(verbosity), capacity_(capacityBytes)
+    {
+        pending_.reserve(capacityBytes);
+        writing_.reserve(capacityBytes);
+        thread_ = std::thread(&ConsoleWriter::run, this);
+    }
+
+    ~ConsoleWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+            held_ = false;
+        }
+
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    ConsoleWriter(const ConsoleWriter &) = delete;
+    ConsoleWriter &operator=(const ConsoleWriter &) = delete;
+
+    bool shows(const Verbosity level) const { return level <= verbosity_; }
+    Verbosity verbosity() const { return verbosity_; }
+
+    void write(const Verbosity level, const std::string &text)
+    {
+        if(!shows(level) || text.empty()) return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if(level != Verbosity::summary && pending_.size() + text.size() > capacity_)
+            {
+                droppedBytes_ += text.size();
+                return;
+            }
+
+            if(droppedBytes_)
+            {
+                pending_ += "[" + std::to_string(droppedBytes_) + " bytes of console output dropped: output too slow]\n";
+                droppedBytes_ = 0u;
+            }
+
+            pending_ += text;
+        }
+
+        wake_.notify_one();
+    }
+
+    /**
+     * Hold writes while a measurement window is open. Never waits.
+     */
+    void hold(const bool held)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            held_ = held;
+        }
+
+        if(!held) wake_.notify_one();
+    }
+
+    /**
+     * Wait until everything queued is on the terminal (before reading stdin).
+     */
+    void drain()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this]() { return pending_.empty() && !busy_; });
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        for(;;)
+        {
+            wake_.wait(lock, [this]() { return stop_ || (!held_ && !pending_.empty()); });
+
+            if(pending_.empty())
+            {
+                if(stop_) break;
+                continue;
+            }
+
+            writing_.swap(pending_);
+            busy_ = true;
+            lock.unlock();
+
+            std::cout << writing_;
+            std::cout.flush();
+            writing_.clear();
+
+            lock.lock();
+            busy_ = false;
+            idle_.notify_all();
+        }
+    }
+
+    Verbosity verbosity_;
+    std::size_t capacity_;
+    std::string pending_;
+    std::string writing_;
+    std::size_t droppedBytes_ = 0u;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    bool held_ = false;
+    bool busy_ = false;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+/**
+ * Persistent writer for Iteration.txt and the per-cycle detail files.
+ * Iteration.txt stays open for the whole run; text is appended to a preallocated
+ * buffer and written by a background thread. While a measurement window is open
+ * the thread holds its writes, and opening a window waits for any write in
+ * flight, so file I/O never overlaps a window. With a DetailLog attached, cycle
+ * detail goes into it instead of one file per cycle.
+ */
+class LogSink
+{
+public:
+    LogSink(const fs::path &iterationLogPath, const std::size_t reserveBytes)
+        : iterationLog_(iterationLogPath, std::ios::app)
+    {
+        pending_.reserve(reserveBytes);
+        writing_.reserve(reserveBytes);
+        thread_ = std::thread(&LogSink::run, this);
+    }
+
+    ~LogSink()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+            inWindow_ = false;
+        }
+
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    LogSink(const LogSink &) = delete;
+    LogSink &operator=(const LogSink &) = delete;
+
+    bool good() const { return iterationLog_.is_open(); }
+
+    /**
+     * Also stream machine-readable records to 'path' (truncated), same rules as Iteration.txt.
+     */
+    bool openResults(const fs::path &path)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_.open(path, std::ios::trunc);
+        resultsPending_.reserve(pending_.capacity());
+        resultsWriting_.reserve(pending_.capacity());
+        return results_.is_open();
+    }
+
+    void appendResults(const std::string &text)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            resultsPending_ += text;
+        }
+
+        wake_.notify_one();
+    }
+
+    void appendIteration(const std::string &text)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_ += text;
+        }
+
+        wake_.notify_one();
+    }
+
+    void writeDetail(const fs::path &path, std::string text)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            details_.emplace_back(path, std::move(text));
+        }
+
+        wake_.notify_one();
+    }
+
+    void attachDetailLog(DetailLog *log)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        detailLog_ = log;
+    }
+
+    /**
+     * Hold 'console' along with the file writes for every window.
+     */
+    void attachConsole(ConsoleWriter *console)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        console_ = console;
+    }
+
+    /**
+     * One cycle's detail: a record in the attached DetailLog, else the file 'path'.
+     */
+    void writeCycleDetail(const n_type cycle, const fs::path &path, std::string text)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if(detailLog_ != nullptr) cycleDetails_.push_back({cycle, path.filename().string(), std::move(text)});
+            else details_.emplace_back(path, std::move(text));
+        }
+
+        wake_.notify_one();
+    }
+
+    /**
+     * Hold background writes until endWindow(); returns once nothing is being written.
+     */
+    void beginWindow()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        inWindow_ = true;
+
+        if(console_) console_->hold(true);
+
+        idle_.wait(lock, [this]() { return !busy_; });
+    }
+
+    void endWindow()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            inWindow_ = false;
+
+            if(console_) console_->hold(false);
+        }
+
+        wake_.notify_one();
+    }
+
+private:
+    void run()
+    {
+        std::vector<std::pair<fs::path, std::string>> details;
+        std::vector<DetailCycle> cycleDetails;
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        for(;;)
+        {
+            wake_.wait(lock, [this]() { return stop_ || (!inWindow_ && hasWork()); });
+
+            if(!hasWork())
+            {
+                if(stop_) break;
+                continue;
+            }
+
+            writing_.swap(pending_);
+            resultsWriting_.swap(resultsPending_);
+            details.swap(details_);
+            cycleDetails.swap(cycleDetails_);
+            busy_ = true;
+            lock.unlock();
+
+            if(!writing_.empty())
+            {
+                iterationLog_ << writing_;
+                iterationLog_.flush();
+                writing_.clear();
+            }
+
+            if(!resultsWriting_.empty())
+            {
+                results_ << resultsWriting_;
+                results_.flush();
+                resultsWriting_.clear();
+            }
+
+            for(const auto &detail : details)
+            {
+                std::ofstream ofs(detail.first);
+
+                if(ofs.is_open()) {
+                    ofs << detail.second;
+                }
+            }
+
+            details.clear();
+
+            for(const DetailCycle &detail : cycleDetails)
+            {
+                if(!detailLog_->appendCycle(detail.cycle, detail.name, detail.text)) std::cerr << "Cannot extend the binary detail log\n";
+            }
+
+            cycleDetails.clear();
+
+            lock.lock();
+            busy_ = false;
+            idle_.notify_all();
+        }
+    }
+
+    bool hasWork() const { return !pending_.empty() || !resultsPending_.empty() || !details_.empty() || !cycleDetails_.empty(); }
+
+    std::ofstream iterationLog_;
+    std::string pending_;
+    std::string writing_;
+    std::ofstream results_;
+    std::string resultsPending_;
+    std::string resultsWriting_;
+    std::vector<std::pair<fs::path, std::string>> details_;
+    std::vector<DetailCycle> cycleDetails_;
+    DetailLog *detailLog_ = nullptr;
+    ConsoleWriter *console_ = nullptr;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    bool inWindow_ = false;
+    bool busy_ = false;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+/**
+ * One lockstep window across all workers, with the anchors that map its raw
+ * monotonic stamps onto wall-clock time.
+ */
+struct WindowRun
+{
+    std::vector<WorkerResult> results;
+    std::chrono::system_clock::time_point anchorSys;
+    std::uint64_t anchorRawNs = 0u;
+    std::uint64_t startNs = 0u;
+    Telemetry telemetry;
+};
+
+/**
+ * Start one worker per entry of 'workerCpus' (-1 leaves it unpinned), wait until all
+ * are ready, then open a 'windowNs' window for them. The log sink holds its writes
+ * until every worker has joined. A collector thread drains each worker's sample ring
+ * every few ms, so workers never lock, allocate or share a cache line. A window.mix
+ * array, when set, gives each worker its own kernel and duty cycle. A non-zero
+ * 'startRawNs' (monotonicRawNs) opens the window at that instant instead, if it is
+ * still ahead once the workers are ready.
+ */
+static void runCycleWindow(CycleWindow &window, const std::vector<int> &workerCpus, const std::uint64_t windowNs,
+                           LogSink &logSink, WindowRun &run, const std::uint64_t startRawNs = 0u)
+{
+    const unsigned threadCount = static_cast<unsigned>(workerCpus.size());
+    std::vector<std::unique_ptr<SampleRing>> rings;
+
+    // legacy-second counts whole wall-clock seconds: the window rounded, at least one
+    window.legacySeconds = static_cast<std::time_t>(std::max<std::uint64_t>((windowNs + 500000000u) / 1000000000u, 1u));
+    std::vector<SampleArena> collected;
+    std::vector<std::thread> workers;
+
+    run.results = std::vector<WorkerResult>(threadCount);
+    rings.reserve(threadCount);
+    collected.reserve(threadCount);
+    workers.reserve(threadCount);
+
+    for(unsigned t = 0u; t < threadCount; ++t)
+    {
+        rings.push_back(std::make_unique<SampleRing>(sampleRingCapacity));
+        collected.emplace_back(window.sampleCapacity);
+    }
+
+    const auto drainRings = [&]()
+    {
+        for(unsigned t = 0u; t < threadCount; ++t)
+        {
+            rings[t]->drain([&collected, t](const ProgressSample &sample) { collected[t].append(sample); });
+        }
+    };
+
+    std::atomic<bool> joined{false};
+    std::thread collector([&]()
+    {
+        while(!joined.load(std::memory_order_acquire))
+        {
+            drainRings();
+            std::this_thread::sleep_for(collectorPeriod);
+        }
+
+        drainRings();
+    });
+
+    for(unsigned t = 0u; t < threadCount; ++t)
+    {
+        workers.emplace_back(runWorker, std::ref(window), std::ref(run.results[t]), std::ref(*rings[t]), workerCpus[t],
+                             window.mix ? &window.mix[t] : nullptr);
+    }
+
+    while(window.ready.load(std::memory_order_acquire) < threadCount)
+    {
+        std::this_thread::yield();
+    }
+
+    logSink.beginWindow();
+
+    if(window.telemetry) window.telemetry->start(workerCpus);
+
+    // Small lead so every worker is spinning before the window opens
+    run.anchorSys   = std::chrono::system_clock::now();
+    run.anchorRawNs = monotonicRawNs();
+
+    window.startNs = std::max<std::uint64_t>(run.anchorRawNs + 1000000u, startRawNs);
+    window.endNs   = window.startNs + windowNs;
+    run.startNs    = window.startNs;
+    window.go.store(true, std::memory_order_release);
+
+    for(auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    if(window.telemetry) run.telemetry = window.telemetry->stop();
+
+    joined.store(true, std::memory_order_release);
+    collector.join();
+
+    for(unsigned t = 0u; t < threadCount; ++t)
+    {
+        run.results[t].droppedSamples += collected[t].dropped();
+        run.results[t].samples = std::move(collected[t]);
+    }
+
+    logSink.endWindow();
+}
+
+/**
+ * Command-line settings. Passing --cycles (or --quiet) makes the run non-interactive.
+ */
+struct Options
+{
+    n_type cycles = 1u;
+    bool cyclesGiven = false;
+    n_type durationMs = 1000u;
+    unsigned threads = 1u;
+    bool threadsGiven = false;
+    fs::path outputDir;
+    Verbosity verbosity = Verbosity::full;
+    std::string kernel = "increment";
+    bool listKernels = false;
+    std::string mode = "cpu";
+    n_type memMaxMib = 0u;
+    n_type memTestMs = 50u;
+    std::string hugePages = "thp";
+    ResultFormat format = ResultFormat::none;
+    fs::path resultsFile;
+    double ciTarget = 0.0;
+    n_type maxCycles = 1000u;
+    n_type warmupMs = 0u;
+    n_type cooldownMs = 0u;
+    bool perfCounters = false;
+    std::string engine = "steady-deadline";
+    bool ab = false;
+    unsigned unroll = 0u;
+    unsigned checkShift = 0u;
+    bool durationGiven = false;
+    bool daemon = false;
+    n_type intervalMs = 10000u;
+    std::string listen = "127.0.0.1:9464";
+    n_type rollingProbes = 60u;
+    std::string c2cCpus;
+    n_type c2cRoundTrips = 1000u;
+    std::vector<unsigned> sweepThreads;
+    bool compareBaseline = false;
+    fs::path baselineDb;
+    bool binaryDetail = false;
+    fs::path exportDetail;
+    n_type exportCycle = 0u;
+    fs::path exportDir;
+    bool telemetry = false;
+    bool selfBenchmark = false;
+    bool threadsAll = false;
+    bool listenGiven = false;
+    bool agent = false;
+    std::vector<std::string> controllerAgents;
+    fs::path profile;
+};
+
+static void printUsage(const char *program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --cycles N         number of test cycles (skips the prompt)\n"
+              << "  --duration-ms N    measurement window per cycle in ms (default 1000)\n"
+              << "  --window LEN       same as --duration-ms with a unit: 10ms, 1.5s, 2m (1 ms up to 24 h)\n"
+              << "  --threads N|all    workers, each pinned to its own CPU (default 1, or the cgroup CPU\n"
+              << "                     quota rounded down, unpinned)\n"
+              << "  --sweep threads=A..B[:S]  run all cycles at A, A+S, ... B threads (doubling without :S;\n"
+              << "                     B may be 'all') and report speedup and efficiency\n"
+              << "  --output-dir DIR   where CycleLog and CycleLogDetail are created (default cwd)\n"
+              << "  --kernel NAME      workload to measure (default increment, simd = best vector path, see --list-kernels)\n"
+              << "  --list-kernels     show the available kernels\n"
+              << "  --profile FILE     JSON workload mix run together each cycle, e.g. {\"workloads\": [\n"
+              << "                     {\"kernel\": \"int-alu\", \"share\": 60}, {\"kernel\": \"pointer-chase\", \"share\": 30},\n"
+              << "                     {\"kernel\": \"simd\", \"share\": 10, \"duty\": 50}]}; optional \"name\", \"threads\",\n"
+              << "                     \"period_ms\" (duty period, default 10) and \"solo\" (false skips the solo baseline)\n"
+              << "  --engine NAME      window timing: steady-deadline (default), tsc, or legacy-second\n"
+              << "                     (runs to a wall-clock second boundary, the window rounded to whole seconds)\n"
+              << "  --ab               also run every other engine each cycle, interleaved, and compare them\n"
+              << "  --unroll 1|4|8     use the compiled loop with this unroll factor (portable kernels only)\n"
+              << "  --check-shift 10|14|18  compiled loop reading the clock every 2^N operations\n"
+              << "  --mode cpu|memory|c2c  kernel throughput (default), memory bandwidth/latency sweep,\n"
+              << "                     or core-to-core cache-line ping-pong latency\n"
+              << "  --c2c-cpus LIST    CPUs for --mode c2c, e.g. 0-3,8 (default every allowed CPU)\n"
+              << "  --c2c-round-trips N  round trips per timed batch and CPU pair (default 1000)\n"
+              << "  --mem-max-mib N    largest memory working set (default 4x last-level cache, >= 64 MiB)\n"
+              << "  --mem-test-ms N    time spent on each memory test and size (default 50)\n"
+              << "  --huge-pages P     memory arena pages: off, thp (default), 2m or 1g (hugetlb,\n"
+              << "                     falling back to thp when the pool is empty)\n"
+              << "  --format FMT       also stream records as json, csv or ndjson\n"
+              << "  --results-file P   where --format output goes (default CycleLog/Results <timestamp>.<fmt>)\n"
+              << "  --warmup-ms N      spin the kernel before each cycle until its rate settles, at most N ms\n"
+              << "  --cooldown-ms N    idle N ms between cycles\n"
+              << "  --ci-target PCT    keep adding cycles until the 95% CI of the mean is within PCT%\n"
+              << "  --max-cycles N     upper bound on cycles for --ci-target (default 1000)\n"
+              << "  --perf-counters    record IPC, cycles, LLC and branch misses, context switches per worker\n"
+              << "  --telemetry        sample frequency, temperature, RAPL package energy and throttling during\n"
+              << "                     each cycle; reports effective GHz, watts and ops/joule\n"
+              << "  --self-benchmark   time the harness's own clock reads, samples, formatting and log\n"
+              << "                     writes per call, estimate their share of a --window and exit\n"
+              << "  --daemon           probe every --interval-ms until SIGTERM and serve OpenMetrics (window default 50 ms)\n"
+              << "  --interval-ms N    time between daemon probes (default 10000)\n"
+              << "  --listen ADDR      metrics endpoint: [host:]port or unix:/path (default 127.0.0.1:9464)\n"
+              << "  --rolling N        probes in the rolling percentile window (default 60)\n"
+              << "  --agent            wait for a --controller and run the cycles it schedules until SIGTERM\n"
+              << "                     (listens on --listen, default 127.0.0.1:9465; use *:9465 for other hosts)\n"
+              << "  --controller LIST  run --cycles synchronised windows on every agent in LIST (host:port,...)\n"
+              << "                     with this --kernel, --threads and --window, and summarise the cluster\n"
+              << "  --compare-baseline flag a significant drop against this host's stored runs (exit status 2)\n"
+              << "  --baseline-db P    run history, appended on every CPU run (default CycleLog/Baseline.db)\n"
+              << "  --detail-format text|binary  one text file per cycle (default) or a single\n"
+              << "                     CycleLogDetail/Detail <timestamp>.cslog for the whole run\n"
+              << "  --export-detail P  print a .cslog back in the text layout and exit\n"
+              << "  --export-cycle N   only that cycle of --export-detail\n"
+              << "  --export-dir DIR   write --export-detail cycles as the original per-cycle files\n"
+              << "  --verbosity LEVEL  console output: none, summary (end of run only), progress (plus one\n"
+              << "                     line per cycle) or full (every cycle's detail, the default)\n"
+              << "  --quiet            same as --verbosity summary: no banner, prompt or per-cycle output\n"
+              << "  --help             show this text\n";
+}
+
+static void printKernels()
+{
+    for(const KernelInfo &kernel : kernelRegistry)
+    {
+        std::cout << "  " << std::left << std::setw(15) << std::setfill(' ') << kernel.name
+                  << (kernel.supported() ? "" : "[unsupported] ") << kernel.description << "\n";
+    }
+
+    const KernelInfo *best = findKernel("simd");
+
+    std::cout << "  " << std::left << std::setw(15) << "simd" << "widest vector kernel this CPU supports (here "
+              << best->name << ", " << best->isa << ")\n";
+}
+
+/**
+ * Parse a positive decimal number; false on junk, zero or overflow.
+ */
+static bool parsePositive(const std::string &text, n_type &value)
+{
+    if(text.empty() || text[0] == '-') return false;
+
+    char *end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = std::strtoull(text.c_str(), &end, 10);
+
+    if(errno != 0 || end == text.c_str() || *end != '\0' || parsed < 1u) return false;
+    if(parsed > std::numeric_limits<n_type>::max()) return false;
+
+    value = static_cast<n_type>(parsed);
+
+    return true;
+}
+
+/**
+ * Parse "threads=FIRST..LAST[:STEP]" into thread counts; LAST may be "all". Without
+ * STEP the counts double from FIRST. LAST is always the final count.
+ */
+static bool parseSweep(const std::string &text, const unsigned cpuCount, std::vector<unsigned> &threads)
+{
+    const std::string prefix = "threads=";
+    const std::size_t dots = text.find("..");
+
+    if(text.compare(0u, prefix.size(), prefix) != 0 || dots == std::string::npos) return false;
+
+    const std::size_t colon = text.find(':', dots);
+    const std::string lastText = text.substr(dots + 2u, colon == std::string::npos ? std::string::npos : colon - dots - 2u);
+    n_type first = 0u;
+    n_type last = cpuCount;
+    n_type step = 0u;
+
+    if(!parsePositive(text.substr(prefix.size(), dots - prefix.size()), first)) return false;
+    if(lastText != "all" && !parsePositive(lastText, last)) return false;
+    if(colon != std::string::npos && !parsePositive(text.substr(colon + 1u), step)) return false;
+    if(first > last || last > 4096u) return false;
+
+    threads.clear();
+
+    for(n_type count = first; count <= last; count = step ? count + step : count * 2u)
+    {
+        threads.push_back(static_cast<unsigned>(count));
+    }
+
+    if(threads.back() != last) threads.push_back(static_cast<unsigned>(last));
+
+    return true;
+}
+
+// Longest window --window or --duration-ms accepts: 24 h, far from wrapping in ns
+static constexpr n_type maxWindowMs = 86400000u;
+
+/**
+ * Parse a window length such as "10ms", "1.5s", "2m" or "2min" into whole ms; a bare
+ * number is ms. False unless the result is between 1 ms and 24 h.
+ */
+static bool parseWindow(const std::string &text, n_type &ms)
+{
+    char *end = nullptr;
+    errno = 0;
+    const double value = std::strtod(text.c_str(), &end);
+    const std::string unit = (end != nullptr) ? std::string(end) : std::string();
+    double scale = 0.0;
+
+    if(unit.empty() || unit == "ms") scale = 1.0;
+    else if(unit == "s") scale = 1000.0;
+    else if(unit == "m" || unit == "min") scale = 60000.0;
+
+    if(errno != 0 || end == text.c_str() || !(scale > 0.0) || !(value > 0.0)) return false;
+
+    const double total = std::round(value * scale);
+
+    if(total < 1.0 || total > static_cast<double>(maxWindowMs)) return false;
+
+    ms = static_cast<n_type>(total);
+
+    return true;
+}
+
+/**
+ * Window length for headers: "10 ms", "1500 ms", "30 s", "2 min".
+ */
+static std::string formatWindow(const n_type ms)
+{
+    if(ms >= 60000u && ms % 60000u == 0u) return std::to_string(ms / 60000u) + " min";
+    if(ms >= 1000u && ms % 1000u == 0u) return std::to_string(ms / 1000u) + " s";
+
+    return std::to_string(ms) + " ms";
+}
+
+/**
+ * Per-call cost of one harness primitive, best of repeated timed batches.
+ */
+struct HarnessCost
+{
+    std::string name;
+    double ns;
+};
+
+/**
+ * What the harness itself costs on this host. The clock and sample figures are the
+ * ones paid inside a window; the rest run between windows.
+ */
+struct HarnessCosts
+{
+    double monotonicRawNs = 0.0;
+    double realtimeNs = 0.0;
+    double tscNs = 0.0;
+    double sampleNs = 0.0;
+    std::vector<HarnessCost> all;
+};
+
+/**
+ * Time the in-window primitives and, with 'full', the formatting and log writes too.
+ * 'budgetNs' is spent on each primitive.
+ */
+static HarnessCosts measureHarnessCosts(const TscClock &tsc, const std::uint64_t budgetNs, const bool full)
+{
+    HarnessCosts costs;
+    std::uint64_t sink = 0u;
+
+    const auto add = [&](const std::string &name, const double ns) { costs.all.push_back({name, ns}); return ns; };
+
+    // Clocks, as the engines read them
+    costs.monotonicRawNs = add("clock_gettime(CLOCK_MONOTONIC_RAW)", bestPassNs([&]() { sink += monotonicRawNs(); keepValue(sink); }, budgetNs));
+    costs.realtimeNs = add("clock_gettime(CLOCK_REALTIME)", bestPassNs([&]() { sink += static_cast<std::uint64_t>(wallClockNow().tv_nsec); keepValue(sink); }, budgetNs));
+
+    if(full)
+    {
+        add("steady_clock::now", bestPassNs([&]() { sink += static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()); keepValue(sink); }, budgetNs));
+        add("system_clock::now", bestPassNs([&]() { sink += static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count()); keepValue(sink); }, budgetNs));
+    }
+
+    if(tscSupported())
+    {
+        costs.tscNs = add("rdtsc", bestPassNs([&]() { sink += readTsc(); keepValue(sink); }, budgetNs));
+
+        if(tsc.usable && full) add("rdtscp / fenced rdtsc", bestPassNs([&]() { sink += tsc.orderedNow(); keepValue(sink); }, budgetNs));
+    }
+
+    // Progress sample: the worker's ring push plus its share of the collector's drain
+    {
+        SampleRing ring(sampleRingCapacity);
+        n_type iteration = 0u;
+
+        costs.sampleNs = add("progress sample (ring push + drain)", bestPassNs([&]()
+        {
+            if(!ring.push({++iteration, sink})) ring.drain([&](const ProgressSample &sample) { sink += sample.iteration; });
+            keepValue(sink);
+        }, budgetNs));
+    }
+
+    if(!full) return costs;
+
+    // Formatting done per cycle and per detail line
+    const n_type big = 123456789012u;
+    const auto now = std::chrono::system_clock::now();
+
+    add("formatWithCommas", bestPassNs([&]() { sink += formatWithCommas(big).size(); keepValue(sink); }, budgetNs));
+    add("formatWithCommas (128-bit)", bestPassNs([&]() { sink += formatWithCommas(static_cast<sum_type>(big) << 40).size(); keepValue(sink); }, budgetNs));
+    add("dateTimeToString", bestPassNs([&]() { sink += dateTimeToString(now).size(); keepValue(sink); }, budgetNs));
+    add("getFileTimestamp", bestPassNs([&]() { sink += getFileTimestamp().size(); keepValue(sink); }, budgetNs));
+    add("fixedText", bestPassNs([&]() { sink += fixedText(1234.5678, 3).size(); keepValue(sink); }, budgetNs));
+
+    // Log writes: what a caller pays to queue a line, and the writer's flush to disk
+    std::error_code ec;
+    const fs::path scratch = fs::temp_directory_path(ec) / ("cpu-stress-self-benchmark-" + std::to_string(getpid()));
+    const std::string line = "Cycle 1 of 1 Iteration 123,456,789 2025-03-16 07:14:02\n";
+
+    {
+        LogSink logSink(scratch, std::size_t(1) << 20);
+        add("LogSink::appendIteration", bestPassNs([&]() { logSink.appendIteration(line); }, budgetNs));
+    }
+
+    {
+        std::ofstream out(scratch, std::ios::trunc);
+        add("log line write + flush", bestPassNs([&]() { out << line; out.flush(); }, budgetNs));
+    }
+
+    fs::remove(scratch, ec);
+
+    return costs;
+}
+
+/**
+ * Harness time inside a window, as a percentage of the window: one clock read per
+ * deadline check plus one sample per progressInterval iterations.
+ */
+static double harnessOverheadPct(const HarnessCosts &costs, const TimingEngine engine, const n_type iterations,
+                                 const unsigned checkShift, const std::uint64_t elapsedNs)
+{
+    if(elapsedNs == 0u) return 0.0;
+
+    const double clockNs = (engine == TimingEngine::tsc) ? costs.tscNs
+                         : (engine == TimingEngine::legacySecond) ? costs.realtimeNs
+                         : costs.monotonicRawNs;
+    const double checks = static_cast<double>(iterations >> checkShift);
+    const double samples = static_cast<double>(iterations / progressInterval);
+    // legacy-second reads CLOCK_MONOTONIC_RAW for each sample; tsc converts the ticks it already has
+    const double sampleNs = costs.sampleNs + ((engine == TimingEngine::legacySecond) ? costs.monotonicRawNs : 0.0);
+
+    return 100.0 * (checks * clockNs + samples * sampleNs) / static_cast<double>(elapsedNs);
+}
+
+/**
+ * --self-benchmark: per-call cost of every primitive, then what they add up to in a
+ * window of the selected kernel and engine.
+ */
+static int runSelfBenchmark(const KernelInfo &kernel, const EngineInfo &engine, const n_type durationMs)
+{
+    constexpr std::uint64_t budgetNs = 100000000u;
+    const TscClock tsc = tscSupported() ? calibrateTscClock() : TscClock{};
+    const HarnessCosts costs = measureHarnessCosts(tsc, budgetNs, true);
+
+    std::cout << "Harness self-benchmark, best of " << budgetNs / 1000000u << " ms per primitive\n";
+
+    for(const HarnessCost &cost : costs.all)
+    {
+        std::cout << "  " << std::left << std::setw(38) << std::setfill(' ') << cost.name << std::right
+                  << std::setw(10) << fixedText(cost.ns, 1) << " ns/call\n";
+    }
+
+    // Expected counts for one window, from the same calibration the cycles use
+    const std::uint64_t windowNs = durationMs * 1000000u;
+    const Calibration calibration = calibrateCheckShift(windowNs, kernel);
+    const n_type iterations = static_cast<n_type>(static_cast<double>(windowNs) / calibration.iterationNs);
+    const double pct = harnessOverheadPct(costs, engine.engine, iterations, calibration.checkShift, windowNs);
+
+    std::cout << "Window of " << formatWindow(durationMs) << " with kernel " << kernel.name << " on " << engine.name
+              << ": " << formatWithCommas(iterations >> calibration.checkShift) << " deadline checks (every 2^"
+              << calibration.checkShift << " ops), " << formatWithCommas(iterations / progressInterval)
+              << " progress samples, harness overhead " << fixedText(pct, 4) << "% of the window\n";
+
+    return 0;
+}
+
+/**
+ * A parsed JSON value: just enough of the format for workload profiles.
+ */
+struct JsonValue
+{
+    enum class Type { null, boolean, number, string, array, object };
+
+    Type type = Type::null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string text;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    const JsonValue *find(const std::string &key) const
+    {
+        for(const auto &member : members)
+        {
+            if(member.first == key) return &member.second;
+        }
+
+        return nullptr;
+    }
+};
+
+/**
+ * Recursive-descent JSON reader. Returns false with 'error' naming the byte offset.
+ */
+class JsonReader
+{
+public:
+    explicit JsonReader(const std::string &text) : text_(text) {}
+
+    bool parse(JsonValue &value, std::string &error)
+    {
+        if(!readValue(value, 0u) || (skipSpace(), pos_ != text_.size()))
+        {
+            error = "invalid JSON at byte " + std::to_string(pos_);
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    void skipSpace()
+    {
+        while(pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) ++pos_;
+    }
+
+    bool consume(const char ch)
+    {
+        skipSpace();
+
+        if(pos_ >= text_.size() || text_[pos_] != ch) return false;
+
+        ++pos_;
+        return true;
+    }
+
+    bool readString(std::string &out)
+    {
+        if(!consume('"')) return false;
+
+        while(pos_ < text_.size() && text_[pos_] != '"')
+        {
+            char ch = text_[pos_++];
+
+            if(ch == '\\')
+            {
+                if(pos_ >= text_.size()) return false;
+
+                ch = text_[pos_++];
+
+                if(ch == 'n') ch = '\n';
+                else if(ch == 't') ch = '\t';
+                else if(ch == 'r') ch = '\r';
+                else if(ch == 'b') ch = '\b';
+                else if(ch == 'f') ch = '\f';
+                else if(ch == 'u')
+                {
+                    // Profiles are ASCII; anything else becomes '?'
+                    if(pos_ + 4u > text_.size()) return false;
+
+                    const unsigned long code = std::strtoul(text_.substr(pos_, 4u).c_str(), nullptr, 16);
+                    pos_ += 4u;
+                    ch = (code < 0x80u) ? static_cast<char>(code) : '?';
+                }
+                else if(ch != '"' && ch != '\\' && ch != '/') return false;
+            }
+
+            out += ch;
+        }
+
+        return consume('"');
+    }
+
+    bool readValue(JsonValue &value, const unsigned depth)
+    {
+        skipSpace();
+
+        if(pos_ >= text_.size() || depth > 32u) return false;
+
+        const char ch = text_[pos_];
+
+        if(ch == '{')
+        {
+            value.type = JsonValue::Type::object;
+            ++pos_;
+
+            if(consume('}')) return true;
+
+            do
+            {
+                std::pair<std::string, JsonValue> member;
+
+                if(!readString(member.first) || !consume(':') || !readValue(member.second, depth + 1u)) return false;
+
+                value.members.push_back(std::move(member));
+            }
+            while(consume(','));
+
+            return consume('}');
+        }
+
+        if(ch == '[')
+        {
+            value.type = JsonValue::Type::array;
+            ++pos_;
+
+            if(consume(']')) return true;
+
+            do
+            {
+                value.items.emplace_back();
+
+                if(!readValue(value.items.back(), depth + 1u)) return false;
+            }
+            while(consume(','));
+
+            return consume(']');
+        }
+
+        if(ch == '"')
+        {
+            value.type = JsonValue::Type::string;
+            return readString(value.text);
+        }
+
+        for(const char *word : {"true", "false", "null"})
+        {
+            const std::size_t length = std::strlen(word);
+
+            if(text_.compare(pos_, length, word) == 0)
+            {
+                value.type = (*word == 'n') ? JsonValue::Type::null : JsonValue::Type::boolean;
+                value.boolean = *word == 't';
+                pos_ += length;
+                return true;
+            }
+        }
+
+        const char *begin = text_.c_str() + pos_;
+        char *end = nullptr;
+        value.type = JsonValue::Type::number;
+        value.number = std::strtod(begin, &end);
+        pos_ += static_cast<std::size_t>(end - begin);
+
+        return end != begin;
+    }
+
+    const std::string &text_;
+    std::size_t pos_ = 0u;
+};
+
+/**
+ * One entry of a workload profile: 'share' is its relative weight in the thread
+ * split, 'dutyPct' the busy part of each duty period.
+ */
+struct Workload
+{
+    std::string name;
+    const KernelInfo *kernel = nullptr;
+    double share = 0.0;
+    unsigned dutyPct = 100u;
+    unsigned threads = 0u;
+    Calibration calibration;
+};
+
+struct WorkloadProfile
+{
+    std::string name;
+    unsigned threads = 0u;
+    n_type periodMs = 10u;
+    bool solo = true;
+    std::vector<Workload> workloads;
+};
+
+/**
+ * Read a --profile file. Unknown keys are ignored; every kernel must exist and run here.
+ */
+static bool loadProfile(const fs::path &path, WorkloadProfile &profile, std::string &error)
+{
+    std::ifstream in(path);
+    std::ostringstream text;
+
+    if(!in.is_open())
+    {
+        error = "cannot open " + path.string();
+        return false;
+    }
+
+    text << in.rdbuf();
+
+    JsonValue root;
+    const std::string json = text.str();
+
+    if(!JsonReader(json).parse(root, error)) return false;
+
+    const JsonValue *workloads = root.find("workloads");
+
+    if(root.type != JsonValue::Type::object || workloads == nullptr || workloads->type != JsonValue::Type::array
+       || workloads->items.empty())
+    {
+        error = "expected an object with a non-empty \"workloads\" array";
+        return false;
+    }
+
+    const auto number = [&root](const char *key, const double fallback, const double low, const double high, double &out)
+    {
+        const JsonValue *value = root.find(key);
+        out = value ? value->number : fallback;
+        return value == nullptr || (value->type == JsonValue::Type::number && out >= low && out <= high);
+    };
+
+    double threads = 0.0;
+    double periodMs = 10.0;
+    const JsonValue *name = root.find("name");
+    const JsonValue *solo = root.find("solo");
+
+    if(!number("threads", 0.0, 1.0, 4096.0, threads) || !number("period_ms", 10.0, 1.0, 60000.0, periodMs)
+       || (solo && solo->type != JsonValue::Type::boolean))
+    {
+        error = "\"threads\" must be 1-4096, \"period_ms\" 1-60000 and \"solo\" true or false";
+        return false;
+    }
+
+    profile.name = (name && name->type == JsonValue::Type::string) ? name->text : path.stem().string();
+    profile.threads = static_cast<unsigned>(threads);
+    profile.periodMs = static_cast<n_type>(periodMs);
+    profile.solo = solo == nullptr || solo->boolean;
+
+    for(const JsonValue &item : workloads->items)
+    {
+        const JsonValue *kernel = item.find("kernel");
+        const JsonValue *share = item.find("share");
+        const JsonValue *duty = item.find("duty");
+        const JsonValue *label = item.find("name");
+        Workload workload;
+
+        if(kernel == nullptr || kernel->type != JsonValue::Type::string || (workload.kernel = findKernel(kernel->text)) == nullptr)
+        {
+            error = "every workload needs a known \"kernel\" (see --list-kernels)";
+            return false;
+        }
+
+        if(!workload.kernel->supported())
+        {
+            error = "kernel " + kernel->text + " is not supported on this CPU";
+            return false;
+        }
+
+        if(share == nullptr || share->type != JsonValue::Type::number || !(share->number > 0.0)
+           || (duty && (duty->type != JsonValue::Type::number || duty->number < 1.0 || duty->number > 100.0)))
+        {
+            error = "workload " + kernel->text + " needs a \"share\" above 0 and a \"duty\" of 1-100";
+            return false;
+        }
+
+        workload.name = (label && label->type == JsonValue::Type::string) ? label->text : kernel->text;
+        workload.share = share->number;
+        workload.dutyPct = duty ? static_cast<unsigned>(duty->number) : 100u;
+        profile.workloads.push_back(workload);
+    }
+
+    return true;
+}
+
+/**
+ * Split 'threads' workers across the workloads by share (largest remainder), at
+ * least one each. Returns one assignment per worker, the workloads in file order.
+ */
+static std::vector<WorkerMix> assignWorkloads(WorkloadProfile &profile, const unsigned threads)
+{
+    const std::size_t count = profile.workloads.size();
+    double totalShare = 0.0;
+    unsigned assigned = 0u;
+    std::vector<std::pair<double, std::size_t>> remainders;
+
+    for(const Workload &w : profile.workloads) totalShare += w.share;
+
+    for(std::size_t k = 0u; k < count; ++k)
+    {
+        Workload &w = profile.workloads[k];
+        const double exact = w.share / totalShare * (threads - count);
+
+        w.threads = 1u + static_cast<unsigned>(exact);
+        assigned += w.threads;
+        remainders.emplace_back(exact - std::floor(exact), k);
+    }
+
+    std::stable_sort(remainders.begin(), remainders.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+
+    for(std::size_t k = 0u; assigned < threads; ++k, ++assigned) ++profile.workloads[remainders[k % count].second].threads;
+
+    std::vector<WorkerMix> mix;
+
+    for(std::size_t k = 0u; k < count; ++k)
+    {
+        const Workload &w = profile.workloads[k];
+        WorkerMix worker;
+        worker.kernel = w.kernel;
+        worker.checkShift = w.calibration.checkShift;
+        worker.dutyPct = w.dutyPct;
+        worker.periodNs = profile.periodMs * 1000000u;
+        worker.workload = static_cast<unsigned>(k);
+
+        mix.insert(mix.end(), w.threads, worker);
+    }
+
+    return mix;
+}
+
+/**
+ * Per-workload throughput across cycles, each workload's part of the aggregate and,
+ * with a solo baseline, how far contention moved it from running alone.
+ */
+static std::string renderWorkloadSummary(const WorkloadProfile &profile, const std::vector<std::vector<double>> &ops,
+                                         const std::vector<double> &soloOps)
+{
+    std::ostringstream out;
+    double total = 0.0;
+
+    for(const std::vector<double> &values : ops) total += computeCycleStats(values).mean;
+
+    out << "Workload mix " << profile.name << ", duty period " << profile.periodMs << " ms\n"
+        << "Workload\tKernel\tThreads\tDuty\tMean ops/sec\tCV\tShare\tSolo ops/sec\tvs solo\n";
+
+    for(std::size_t k = 0u; k < profile.workloads.size(); ++k)
+    {
+        const Workload &w = profile.workloads[k];
+        const CycleStats stats = computeCycleStats(ops[k]);
+
+        out << w.name << "\t" << w.kernel->name << "\t" << w.threads << "\t" << w.dutyPct << "%\t"
+            << fixedText(stats.mean, 0) << "\t" << fixedText(stats.cv * 100.0, 2) << "%\t"
+            << fixedText(total > 0.0 ? stats.mean / total * 100.0 : 0.0, 1) << "%\t";
+
+        if(k < soloOps.size() && soloOps[k] > 0.0)
+        {
+            const double delta = stats.mean / soloOps[k] - 1.0;
+            out << fixedText(soloOps[k], 0) << "\t" << (delta >= 0.0 ? "+" : "") << fixedText(delta * 100.0, 2) << "%\n";
+        }
+        else
+        {
+            out << "-\t-\n";
+        }
+    }
+
+    return out.str();
+}
+
+/**
+ * Fill 'opts' from argv. Returns false (after printing why) on bad input.
+ */
+static bool parseArguments(const int argc, char *argv[], const unsigned cpuCount, Options &opts, bool &showHelp)
+{
+    for(int a = 1; a < argc; ++a)
+    {
+        const std::string arg = argv[a];
+
+        if(arg == "--help" || arg == "-h")
+        {
+            showHelp = true;
+            continue;
+        }
+
+        if(arg == "--quiet" || arg == "-q")
+        {
+            opts.verbosity = Verbosity::summary;
+            continue;
+        }
+
+        if(arg == "--list-kernels")
+        {
+            opts.listKernels = true;
+            continue;
+        }
+
+        if(arg == "--perf-counters")
+        {
+            opts.perfCounters = true;
+            continue;
+        }
+
+        if(arg == "--ab")
+        {
+            opts.ab = true;
+            continue;
+        }
+
+        if(arg == "--daemon")
+        {
+            opts.daemon = true;
+            continue;
+        }
+
+        if(arg == "--compare-baseline")
+        {
+            opts.compareBaseline = true;
+            continue;
+        }
+
+        if(arg == "--telemetry")
+        {
+            opts.telemetry = true;
+            continue;
+        }
+
+        if(arg == "--self-benchmark")
+        {
+            opts.selfBenchmark = true;
+            continue;
+        }
+
+        if(arg == "--agent")
+        {
+            opts.agent = true;
+            continue;
+        }
+
+        if(arg != "--cycles" && arg != "--duration-ms" && arg != "--threads" && arg != "--output-dir"
+           && arg != "--kernel" && arg != "--mode" && arg != "--mem-max-mib" && arg != "--mem-test-ms"
+           && arg != "--huge-pages"           && arg != "--format" && arg != "--results-file" && arg != "--ci-target" && arg != "--max-cycles"
+           && arg != "--warmup-ms" && arg != "--cooldown-ms" && arg != "--engine"
+           && arg != "--unroll" && arg != "--check-shift" && arg != "--interval-ms" && arg != "--listen"
+           && arg != "--rolling" && arg != "--c2c-cpus" && arg != "--c2c-round-trips" && arg != "--sweep"
+           && arg != "--baseline-db" && arg != "--detail-format" && arg != "--export-detail"
+           && arg != "--export-cycle" && arg != "--export-dir" && arg != "--window" && arg != "--controller"
+           && arg != "--verbosity" && arg != "--profile")
+        {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+
+        if(a + 1 >= argc)
+        {
+            std::cerr << arg << " requires a value\n";
+            return false;
+        }
+
+        const std::string value = argv[++a];
+        n_type number = 0u;
+
+        if(arg == "--output-dir")
+        {
+            opts.outputDir = value;
+        }
+        else if(arg == "--kernel")
+        {
+            opts.kernel = value;
+        }
+        else if(arg == "--engine")
+        {
+            opts.engine = value;
+        }
+        else if(arg == "--listen")
+        {
+            opts.listen = value;
+            opts.listenGiven = true;
+        }
+        else if(arg == "--controller")
+        {
+            std::istringstream list(value);
+            std::string address;
+
+            while(std::getline(list, address, ','))
+            {
+                if(address.empty() || address.find(':') == std::string::npos)
+                {
+                    std::cerr << "Invalid --controller value: " << value << " (expected host:port,...)\n";
+                    return false;
+                }
+
+                opts.controllerAgents.push_back(address);
+            }
+
+            if(opts.controllerAgents.empty())
+            {
+                std::cerr << "--controller needs at least one host:port\n";
+                return false;
+            }
+        }
+        else if(arg == "--c2c-cpus")
+        {
+            opts.c2cCpus = value;
+        }
+        else if(arg == "--sweep")
+        {
+            if(!parseSweep(value, cpuCount, opts.sweepThreads))
+            {
+                std::cerr << "Invalid --sweep value: " << value << " (expected threads=A..B[:S])\n";
+                return false;
+            }
+        }
+        else if(arg == "--format")
+        {
+            if(value == "json") opts.format = ResultFormat::json;
+            else if(value == "csv") opts.format = ResultFormat::csv;
+            else if(value == "ndjson") opts.format = ResultFormat::ndjson;
+            else
+            {
+                std::cerr << "Invalid --format value: " << value << "\n";
+                return false;
+            }
+        }
+        else if(arg == "--results-file")
+        {
+            opts.resultsFile = value;
+        }
+        else if(arg == "--profile")
+        {
+            opts.profile = value;
+        }
+        else if(arg == "--baseline-db")
+        {
+            opts.baselineDb = value;
+        }
+        else if(arg == "--export-detail")
+        {
+            opts.exportDetail = value;
+        }
+        else if(arg == "--export-dir")
+        {
+            opts.exportDir = value;
+        }
+        else if(arg == "--window")
+        {
+            if(!parseWindow(value, opts.durationMs))
+            {
+                std::cerr << "Invalid --window value: " << value << " (1ms to 24h, e.g. 10ms, 1.5s, 2m)\n";
+                return false;
+            }
+
+            opts.durationGiven = true;
+        }
+        else if(arg == "--verbosity")
+        {
+            if(value == "none") opts.verbosity = Verbosity::none;
+            else if(value == "summary") opts.verbosity = Verbosity::summary;
+            else if(value == "progress") opts.verbosity = Verbosity::progress;
+            else if(value == "full") opts.verbosity = Verbosity::full;
+            else
+            {
+                std::cerr << "Invalid --verbosity value: " << value << "\n";
+                return false;
+            }
+        }
+        else if(arg == "--detail-format")
+        {
+            if(value != "text" && value != "binary")
+            {
+                std::cerr << "Invalid --detail-format value: " << value << "\n";
+                return false;
+            }
+
+            opts.binaryDetail = value == "binary";
+        }
+        else if(arg == "--warmup-ms" || arg == "--cooldown-ms")
+        {
+            // Zero is allowed here (it disables the phase), unlike the other counts
+            if(value != "0" && !parsePositive(value, number))
+            {
+                std::cerr << "Invalid " << arg << " value: " << value << "\n";
+                return false;
+            }
+
+            if(arg == "--warmup-ms") opts.warmupMs = number;
+            else opts.cooldownMs = number;
+        }
+        else if(arg == "--ci-target")
+        {
+            char *end = nullptr;
+            opts.ciTarget = std::strtod(value.c_str(), &end);
+
+            if(end == value.c_str() || *end != '\0' || !(opts.ciTarget > 0.0))
+            {
+                std::cerr << "Invalid --ci-target value: " << value << "\n";
+                return false;
+            }
+        }
+        else if(arg == "--mode")
+        {
+            if(value != "cpu" && value != "memory" && value != "c2c")
+            {
+                std::cerr << "Invalid --mode value: " << value << "\n";
+                return false;
+            }
+
+            opts.mode = value;
+        }
+        else if(arg == "--huge-pages")
+        {
+            if(value != "off" && value != "thp" && value != "2m" && value != "1g")
+            {
+                std::cerr << "Invalid --huge-pages value: " << value << "\n";
+                return false;
+            }
+
+            opts.hugePages = value;
+        }
+        else if(arg == "--threads" && value == "all")
+        {
+            opts.threads = cpuCount;
+            opts.threadsGiven = true;
+            opts.threadsAll = true;
+        }
+        else if(!parsePositive(value, number))
+        {
+            std::cerr << "Invalid " << arg << " value: " << value << "\n";
+            return false;
+        }
+        else if(arg == "--cycles")
+        {
+            opts.cycles = number;
+            opts.cyclesGiven = true;
+        }
+        else if(arg == "--duration-ms")
+        {
+            if(number > maxWindowMs)
+            {
+                std::cerr << "Invalid --duration-ms value: " << value << " (1 to " << maxWindowMs << " ms)\n";
+                return false;
+            }
+
+            opts.durationMs = number;
+            opts.durationGiven = true;
+        }
+        else if(arg == "--mem-max-mib")
+        {
+            opts.memMaxMib = number;
+        }
+        else if(arg == "--mem-test-ms")
+        {
+            opts.memTestMs = number;
+        }
+        else if(arg == "--c2c-round-trips")
+        {
+            opts.c2cRoundTrips = number;
+        }
+        else if(arg == "--export-cycle")
+        {
+            opts.exportCycle = number;
+        }
+        else if(arg == "--max-cycles")
+        {
+            opts.maxCycles = number;
+        }
+        else if(arg == "--interval-ms")
+        {
+            opts.intervalMs = number;
+        }
+        else if(arg == "--rolling")
+        {
+            opts.rollingProbes = number;
+        }
+        else if(arg == "--unroll")
+        {
+            opts.unroll = static_cast<unsigned>(std::min<n_type>(number, 1024u));
+        }
+        else if(arg == "--check-shift")
+        {
+            opts.checkShift = static_cast<unsigned>(std::min<n_type>(number, 64u));
+        }
+        else
+        {
+            opts.threads = static_cast<unsigned>(number);
+            opts.threadsGiven = true;
+            opts.threadsAll = false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * A listening stream socket on TCP ("host:port" or "port", host 127.0.0.1 by default
+ * and "*" for every interface) or a Unix socket ("unix:/path"). Returns the fd, or -1
+ * with 'error' set; 'unixPath' is the socket file this call created, to unlink on shutdown.
+ */
+static int listenSocket(const std::string &listen, std::string &unixPath, std::string &error)
+{
+    int fd = -1;
+
+    const auto fail = [&fd, &error]()
+    {
+        error = std::strerror(errno);
+
+        if(fd >= 0) ::close(fd);
+
+        return -1;
+    };
+
+    if(listen.compare(0, 5, "unix:") == 0)
+    {
+        sockaddr_un addr{};
+        const std::string path = listen.substr(5);
+
+        if(path.empty() || path.size() >= sizeof(addr.sun_path))
+        {
+            error = "invalid socket path";
+            return -1;
+        }
+
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1u);
+
+        // Only a stale socket is replaced; any other file at the path is left alone
+        struct stat existing{};
+
+        if(::lstat(path.c_str(), &existing) == 0)
+        {
+            if(!S_ISSOCK(existing.st_mode))
+            {
+                error = "address in use";
+                return -1;
+            }
+
+            ::unlink(path.c_str());
+        }
+
+        fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+        if(fd < 0 || ::bind(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0) return fail();
+
+        // Set only once bound, so shutdown unlinks nothing but the socket created here
+        unixPath = path;
+    }
+    else
+    {
+        const std::size_t colon = listen.rfind(':');
+        const std::string host = (colon == std::string::npos) ? "127.0.0.1" : listen.substr(0, colon);
+        const std::string port = (colon == std::string::npos) ? listen : listen.substr(colon + 1u);
+        n_type portNumber = 0u;
+        sockaddr_in addr{};
+
+        addr.sin_family = AF_INET;
+
+        if(!parsePositive(port, portNumber) || portNumber > 65535u
+           || ::inet_pton(AF_INET, (host.empty() || host == "*") ? "0.0.0.0" : host.c_str(), &addr.sin_addr) != 1)
+        {
+            error = "expected [host:]port or unix:/path";
+            return -1;
+        }
+
+        addr.sin_port = htons(static_cast<std::uint16_t>(portNumber));
+        fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+        const int reuse = 1;
+        if(fd >= 0) ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        if(fd < 0 || ::bind(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0) return fail();
+    }
+
+    if(::listen(fd, 16) != 0) return fail();
+
+    return fd;
+}
+
+/**
+ * Serves one OpenMetrics text page over HTTP, on TCP ("host:port" or "port") or a
+ * Unix socket ("unix:/path"). The page is rendered by the prober and only copied
+ * here. Requests that arrive while a probe window is open wait until it closes,
+ * so a scrape never lands inside a measurement.
+ */
+class MetricsServer
+{
+public:
+    explicit MetricsServer(const std::string &listen)
+    {
+        fd_ = listenSocket(listen, unixPath_, error_);
+
+        if(fd_ < 0) return;
+
+        thread_ = std::thread(&MetricsServer::run, this);
+    }
+
+    ~MetricsServer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+            held_ = false;
+        }
+
+        released_.notify_all();
+
+        if(thread_.joinable()) thread_.join();
+        if(fd_ >= 0) ::close(fd_);
+        if(!unixPath_.empty() && error_.empty()) ::unlink(unixPath_.c_str());
+    }
+
+    MetricsServer(const MetricsServer &) = delete;
+    MetricsServer &operator=(const MetricsServer &) = delete;
+
+    bool good() const { return error_.empty(); }
+    const std::string &error() const { return error_; }
+
+    void publish(std::string page)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        page_ = std::move(page);
+    }
+
+    /**
+     * Hold request handling while a probe window is open.
+     */
+    void hold(const bool held)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            held_ = held;
+        }
+
+        if(!held) released_.notify_all();
+    }
+
+private:
+    void run()
+    {
+        for(;;)
+        {
+            pollfd listener{fd_, POLLIN, 0};
+            const int ready = ::poll(&listener, 1, 250);
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            released_.wait(lock, [this]() { return !held_; });
+
+            if(stop_) return;
+            if(ready <= 0) continue;
+
+            const std::string page = page_;
+            lock.unlock();
+
+            const int client = ::accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC);
+
+            if(client >= 0)
+            {
+                respond(client, page);
+                ::close(client);
+            }
+        }
+    }
+
+    /**
+     * Read the request line (1 s limit) and answer GET / or /metrics; anything else is a 404.
+     */
+    static void respond(const int client, const std::string &page)
+    {
+        std::string request;
+        char chunk[1024];
+
+        while(request.find("\r\n\r\n") == std::string::npos && request.size() < 8192u)
+        {
+            pollfd in{client, POLLIN, 0};
+
+            if(::poll(&in, 1, 1000) <= 0) break;
+
+            const ssize_t got = ::recv(client, chunk, sizeof(chunk), 0);
+
+            if(got <= 0) break;
+
+            request.append(chunk, static_cast<std::size_t>(got));
+        }
+
+        const std::string line = request.substr(0, request.find("\r\n"));
+        const bool found = line.compare(0, 13, "GET /metrics ") == 0 || line.compare(0, 6, "GET / ") == 0;
+        const std::string body = found ? page : "not found\n";
+
+        std::ostringstream out;
+        out << "HTTP/1.0 " << (found ? "200 OK" : "404 Not Found") << "\r\n"
+            << "Content-Type: " << (found ? "application/openmetrics-text; version=1.0.0; charset=utf-8" : "text/plain") << "\r\n"
+            << "Content-Length: " << body.size() << "\r\n"
+            << "Connection: close\r\n\r\n"
+            << body;
+
+        const std::string response = out.str();
+
+        for(std::size_t sent = 0u; sent < response.size();)
+        {
+            const ssize_t n = ::send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+
+            if(n <= 0) break;
+
+            sent += static_cast<std::size_t>(n);
+        }
+    }
+
+    int fd_ = -1;
+    std::string unixPath_;
+    std::string error_;
+    std::mutex mutex_;
+    std::condition_variable released_;
+    std::string page_ = "# EOF\n";
+    bool held_ = false;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+/**
+ * Per-CPU jiffies from /proc/stat: idle (idle + iowait) and total.
+ */
+struct CpuTimes
+{
+    std::uint64_t idle = 0u;
+    std::uint64_t total = 0u;
+};
+
+static std::map<int, CpuTimes> readCpuTimes()
+{
+    std::map<int, CpuTimes> times;
+    std::ifstream stat("/proc/stat");
+    std::string line;
+
+    while(std::getline(stat, line))
+    {
+        if(line.compare(0, 3, "cpu") != 0 || line.size() < 4u || !std::isdigit(static_cast<unsigned char>(line[3]))) continue;
+
+        std::istringstream fields(line.substr(3));
+        int cpu = -1;
+        std::uint64_t value = 0u;
+        CpuTimes entry;
+
+        fields >> cpu;
+
+        for(int column = 0; fields >> value; ++column)
+        {
+            entry.total += value;
+            if(column == 3 || column == 4) entry.idle += value;
+        }
+
+        times[cpu] = entry;
+    }
+
+    return times;
+}
+
+/**
+ * The 'count' allowed CPUs that were idle longest between two /proc/stat reads.
+ */
+static std::vector<int> idlestCpus(const std::vector<int> &allowed, const std::map<int, CpuTimes> &before,
+                                   const std::map<int, CpuTimes> &after, const unsigned count)
+{
+    std::vector<std::pair<double, int>> ranked;
+
+    for(const int cpu : allowed)
+    {
+        const auto b = before.find(cpu);
+        const auto a = after.find(cpu);
+        double idle = 0.0;
+
+        if(b != before.end() && a != after.end() && a->second.total > b->second.total)
+        {
+            idle = static_cast<double>(a->second.idle - b->second.idle) / static_cast<double>(a->second.total - b->second.total);
+        }
+
+        ranked.emplace_back(-idle, cpu);
+    }
+
+    std::stable_sort(ranked.begin(), ranked.end());
+
+    std::vector<int> cpus;
+
+    for(unsigned t = 0u; t < count && !ranked.empty(); ++t) cpus.push_back(ranked[t % ranked.size()].second);
+
+    return cpus;
+}
+
+// Set from SIGINT/SIGTERM; the daemon (or agent) finishes its current window and exits
+static volatile std::sig_atomic_t daemonStopRequested = 0;
+
+static void requestDaemonStop(int)
+{
+    daemonStopRequested = 1;
+}
+
+static void catchStopSignals()
+{
+    struct sigaction action{};
+    action.sa_handler = requestDaemonStop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+}
+
+/**
+ * What every daemon probe, or every window of one agent run, shares.
+ */
+struct ProbeSetup
+{
+    const KernelInfo *kernel = nullptr;
+    const EngineInfo *engine = nullptr;
+    const TscClock *tsc = nullptr;
+    const VariantInfo *variant = nullptr;
+    unsigned checkShift = 16u;
+    std::size_t sampleCapacity = 0u;
+    std::uint64_t windowNs = 0u;
+    unsigned threads = 1u;
+    bool perfCounters = false;
+};
+
+/**
+ * Running totals and the rolling window of per-probe aggregate ops/sec.
+ */
+struct ProbeHistory
+{
+    std::deque<double> rolling;
+    std::size_t capacity = 60u;
+    n_type probes = 0u;
+    double opsSum = 0.0;
+    double lastOps = 0.0;
+    double lastMhz = 0.0;
+    double lastIpc = 0.0;
+    std::uint64_t lastEpochNs = 0u;
+    PerfCounts perfTotals;
+};
+
+/**
+ * The OpenMetrics page for the current history. Quantiles are over the rolling
+ * window; _sum, _count and the counter totals cover the daemon's whole lifetime.
+ */
+static std::string renderMetrics(const ProbeSetup &setup, const ProbeHistory &history, const std::string &host)
+{
+    const CycleStats stats = computeCycleStats(std::vector<double>(history.rolling.begin(), history.rolling.end()));
+    const std::string labels = "kernel=\"" + jsonEscape(setup.kernel->name) + "\",engine=\"" + setup.engine->name + "\"";
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+
+    out << "# TYPE cpu_stress info\n"
+        << "cpu_stress_info{" << labels << ",isa=\"" << setup.kernel->isa << "\",host=\"" << jsonEscape(host)
+        << "\",threads=\"" << setup.threads << "\",window_ms=\"" << setup.windowNs / 1000000u << "\"} 1\n"
+        << "# TYPE cpu_stress_probes counter\n"
+        << "cpu_stress_probes_total{" << labels << "} " << history.probes << "\n"
+        << "# TYPE cpu_stress_ops_per_second summary\n";
+
+    if(stats.count)
+    {
+        out << "cpu_stress_ops_per_second{" << labels << ",quantile=\"0.01\"} " << fixedText(stats.p1, 1) << "\n"
+            << "cpu_stress_ops_per_second{" << labels << ",quantile=\"0.5\"} " << fixedText(stats.median, 1) << "\n"
+            << "cpu_stress_ops_per_second{" << labels << ",quantile=\"0.99\"} " << fixedText(stats.p99, 1) << "\n";
+    }
+
+    out << "cpu_stress_ops_per_second_sum{" << labels << "} " << fixedText(history.opsSum, 1) << "\n"
+        << "cpu_stress_ops_per_second_count{" << labels << "} " << history.probes << "\n"
+        << "# TYPE cpu_stress_last_ops_per_second gauge\n"
+        << "cpu_stress_last_ops_per_second{" << labels << "} " << fixedText(history.lastOps, 1) << "\n"
+        << "# TYPE cpu_stress_rolling_mean_ops_per_second gauge\n"
+        << "cpu_stress_rolling_mean_ops_per_second{" << labels << "} " << fixedText(stats.mean, 1) << "\n"
+        << "# TYPE cpu_stress_rolling_cv gauge\n"
+        << "cpu_stress_rolling_cv{" << labels << "} " << fixedText(stats.cv, 6) << "\n"
+        << "# TYPE cpu_stress_cpu_mhz gauge\n"
+        << "cpu_stress_cpu_mhz{" << labels << "} " << fixedText(history.lastMhz, 1) << "\n"
+        << "# TYPE cpu_stress_last_probe_timestamp_seconds gauge\n"
+        << "cpu_stress_last_probe_timestamp_seconds{" << labels << "} " << fixedText(static_cast<double>(history.lastEpochNs) / 1e9, 3) << "\n";
+
+    if(history.perfTotals.hasHardware)
+    {
+        out << "# TYPE cpu_stress_ipc gauge\n"
+            << "cpu_stress_ipc{" << labels << "} " << fixedText(history.lastIpc, 3) << "\n"
+            << "# TYPE cpu_stress_cycles counter\n"
+            << "cpu_stress_cycles_total{" << labels << "} " << history.perfTotals.cycles << "\n"
+            << "# TYPE cpu_stress_instructions counter\n"
+            << "cpu_stress_instructions_total{" << labels << "} " << history.perfTotals.instructions << "\n"
+            << "# TYPE cpu_stress_llc_misses counter\n"
+            << "cpu_stress_llc_misses_total{" << labels << "} " << history.perfTotals.llcMisses << "\n"
+            << "# TYPE cpu_stress_branch_misses counter\n"
+            << "cpu_stress_branch_misses_total{" << labels << "} " << history.perfTotals.branchMisses << "\n";
+    }
+
+    if(history.perfTotals.hasContextSwitches)
+    {
+        out << "# TYPE cpu_stress_context_switches counter\n"
+            << "cpu_stress_context_switches_total{" << labels << "} " << history.perfTotals.contextSwitches << "\n";
+    }
+
+    out << "# EOF\n";
+
+    return out.str();
+}
+
+/**
+ * --daemon: one short probe per interval on the idlest allowed CPUs until SIGINT or
+ * SIGTERM, publishing rolling statistics on 'metrics'. Returns the exit code.
+ */
+static int runDaemon(const ProbeSetup &setup, const std::vector<int> &allowedCpus, const n_type intervalMs,
+                     const std::size_t rollingProbes, MetricsServer &metrics, LogSink &logSink,
+                     ResultFormatter &formatter, const bool writeResults, ConsoleWriter &console)
+{
+    catchStopSignals();
+
+    ProbeHistory history;
+    history.capacity = rollingProbes;
+
+    const std::string host = hostName();
+    std::map<int, CpuTimes> lastTimes = readCpuTimes();
+
+    metrics.publish(renderMetrics(setup, history, host));
+
+    while(!daemonStopRequested)
+    {
+        const std::uint64_t probeStartNs = monotonicRawNs();
+        const std::map<int, CpuTimes> times = readCpuTimes();
+        const std::vector<int> cpus = idlestCpus(allowedCpus, lastTimes, times, setup.threads);
+        lastTimes = times;
+
+        CycleWindow window;
+        window.checkShift = setup.checkShift;
+        window.sampleCapacity = setup.sampleCapacity;
+        window.kernel = setup.kernel;
+        window.perfCounters = setup.perfCounters;
+        window.engine = setup.engine->engine;
+        window.tsc = setup.tsc;
+        window.variant = setup.variant;
+
+        WindowRun run;
+
+        metrics.hold(true);
+        runCycleWindow(window, cpus, setup.windowNs, logSink, run);
+        metrics.hold(false);
+
+        double opsPerSec = 0.0;
+        double mhz = 0.0;
+
+        for(unsigned t = 0u; t < setup.threads; ++t)
+        {
+            const WorkerResult &r = run.results[t];
+            opsPerSec += opsPerSecond(r);
+            mhz += r.cpuMhz / setup.threads;
+
+            PerfCounts &totals = history.perfTotals;
+
+            if(r.perf.hasHardware)
+            {
+                totals.hasHardware = true;
+                totals.cycles       += r.perf.cycles;
+                totals.instructions += r.perf.instructions;
+                totals.llcMisses    += r.perf.llcMisses;
+                totals.branchMisses += r.perf.branchMisses;
+            }
+
+            if(r.perf.hasContextSwitches)
+            {
+                totals.hasContextSwitches = true;
+                totals.contextSwitches += r.perf.contextSwitches;
+            }
+        }
+
+        const PerfCounts &first = run.results.front().perf;
+
+        ++history.probes;
+        history.opsSum += opsPerSec;
+        history.lastOps = opsPerSec;
+        history.lastMhz = mhz;
+        history.lastIpc = first.cycles ? static_cast<double>(first.instructions) / static_cast<double>(first.cycles) : 0.0;
+        history.lastEpochNs = epochNs(run.anchorSys) + (run.startNs - run.anchorRawNs);
+        history.rolling.push_back(opsPerSec);
+
+        if(history.rolling.size() > history.capacity) history.rolling.pop_front();
+
+        metrics.publish(renderMetrics(setup, history, host));
+
+        if(writeResults)
+        {
+            ResultRecord record;
+            record.record     = "probe";
+            record.cycle      = history.probes;
+            record.threads    = setup.threads;
+            record.cpu        = cpus.front();
+            record.kernel     = setup.kernel->name;
+            record.engine     = setup.engine->name;
+            record.isa        = setup.kernel->isa;
+            record.startNs    = history.lastEpochNs;
+            record.endNs      = history.lastEpochNs + run.results.front().elapsedNs;
+            record.iterations = 0u;
+            record.opsPerSec  = opsPerSec;
+            record.cpuMhz     = mhz;
+
+            for(const WorkerResult &r : run.results) record.iterations += r.iterations;
+
+            logSink.appendResults(formatter.format(record));
+        }
+
+        console.write(Verbosity::progress, dateTimeToString(run.anchorSys) + " probe " + std::to_string(history.probes)
+                      + " CPU " + std::to_string(cpus.front()) + " Ops/sec " + formatWithCommas(static_cast<n_type>(opsPerSec)) + "\n");
+
+        // Sleep out the rest of the interval in short steps so a signal is seen promptly
+        const std::uint64_t nextNs = probeStartNs + intervalMs * 1000000u;
+
+        for(std::uint64_t nowNs = monotonicRawNs(); !daemonStopRequested && nowNs < nextNs; nowNs = monotonicRawNs())
+        {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(std::min<std::uint64_t>(nextNs - nowNs, 100000000u)));
+        }
+    }
+
+    std::ostringstream itLog;
+    itLog << "Daemon stopped " << dateTimeToString(std::chrono::system_clock::now()) << " after " << history.probes << " probes\n"
+          << std::string(33, '_') << "\n\n";
+    logSink.appendIteration(itLog.str());
+
+    if(writeResults) logSink.appendResults(formatter.footer());
+
+    return 0;
+}
+
+// Cluster protocol: newline-terminated text lines, one request or reply per line
+static const char clusterProtocol[] = "cpu-stress-cluster/1";
+static constexpr std::uint64_t agentSpinLeadNs = 20000000u;
+static constexpr std::uint64_t agentIdleNs = 300000000000u;
+
+/**
+ * Connect to "host:port" (names resolved, IPv4 or IPv6, "[::1]:port" style allowed)
+ * or "unix:/path", giving up after 'timeoutMs'. Returns the fd, or -1 with 'error' set.
+ */
+static int connectSocket(const std::string &address, const int timeoutMs, std::string &error)
+{
+    const auto connectTimed = [timeoutMs, &error](const int family, const sockaddr *addr, const socklen_t length)
+    {
+        const int fd = ::socket(family, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+
+        if(fd < 0)
+        {
+            error = std::strerror(errno);
+            return -1;
+        }
+
+        int status = ::connect(fd, addr, length) == 0 ? 0 : errno;
+
+        if(status == EINPROGRESS)
+        {
+            pollfd out{fd, POLLOUT, 0};
+            socklen_t size = sizeof(status);
+
+            if(::poll(&out, 1, timeoutMs) <= 0) status = ETIMEDOUT;
+            else if(::getsockopt(fd, SOL_SOCKET, SO_ERROR, &status, &size) != 0) status = errno;
+        }
+
+        if(status != 0)
+        {
+            error = std::strerror(status);
+            ::close(fd);
+            return -1;
+        }
+
+        const int noDelay = 1;
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+        if(family != AF_UNIX) ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        return fd;
+    };
+
+    if(address.compare(0, 5, "unix:") == 0)
+    {
+        sockaddr_un addr{};
+        const std::string path = address.substr(5);
+
+        if(path.empty() || path.size() >= sizeof(addr.sun_path))
+        {
+            error = "invalid socket path";
+            return -1;
+        }
+
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1u);
+
+        return connectTimed(AF_UNIX, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr));
+    }
+
+    const std::size_t colon = address.rfind(':');
+    std::string host = address.substr(0, colon);
+    const std::string port = address.substr(colon + 1u);
+
+    if(host.size() > 2u && host.front() == '[' && host.back() == ']') host = host.substr(1u, host.size() - 2u);
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *found = nullptr;
+
+    if(colon == std::string::npos || host.empty() || port.empty())
+    {
+        error = "expected host:port or unix:/path";
+        return -1;
+    }
+
+    const int resolved = ::getaddrinfo(host.c_str(), port.c_str(), &hints, &found);
+
+    if(resolved != 0)
+    {
+        error = ::gai_strerror(resolved);
+        return -1;
+    }
+
+    int fd = -1;
+
+    for(const addrinfo *candidate = found; candidate != nullptr && fd < 0; candidate = candidate->ai_next)
+    {
+        fd = connectTimed(candidate->ai_family, candidate->ai_addr, candidate->ai_addrlen);
+    }
+
+    ::freeaddrinfo(found);
+
+    return fd;
+}
+
+/**
+ * Newline-delimited text over a connected stream socket. Owns the fd.
+ */
+class LineSocket
+{
+public:
+    explicit LineSocket(const int fd) : fd_(fd) {}
+
+    ~LineSocket()
+    {
+        if(fd_ >= 0) ::close(fd_);
+    }
+
+    LineSocket(const LineSocket &) = delete;
+    LineSocket &operator=(const LineSocket &) = delete;
+
+    bool open() const { return fd_ >= 0 && !closed_; }
+
+    bool sendLine(const std::string &line)
+    {
+        const std::string data = line + "\n";
+
+        for(std::size_t sent = 0u; sent < data.size();)
+        {
+            const ssize_t n = ::send(fd_, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+
+            if(n < 0 && errno == EINTR) continue;
+
+            if(n <= 0)
+            {
+                closed_ = true;
+                return false;
+            }
+
+            sent += static_cast<std::size_t>(n);
+        }
+
+        return true;
+    }
+
+    /**
+     * The next line without its terminator, waiting until 'deadlineNs' (monotonicRawNs).
+     * False on timeout, or when the peer hung up or sent a line over 4 KiB (open() is
+     * then false too).
+     */
+    bool readLine(std::string &line, const std::uint64_t deadlineNs)
+    {
+        for(;;)
+        {
+            const std::size_t eol = pending_.find('\n');
+
+            if(eol != std::string::npos)
+            {
+                line = pending_.substr(0, (eol > 0u && pending_[eol - 1u] == '\r') ? eol - 1u : eol);
+                pending_.erase(0, eol + 1u);
+                return true;
+            }
+
+            const std::uint64_t nowNs = monotonicRawNs();
+
+            if(!open() || nowNs >= deadlineNs) return false;
+
+            if(!receive(static_cast<int>(std::min<std::uint64_t>((deadlineNs - nowNs) / 1000000u + 1u, 1000u)))) return false;
+        }
+    }
+
+    /**
+     * Wait up to 'ms' for the peer to hang up; true if it did. Anything it sends
+     * meanwhile is kept for readLine().
+     */
+    bool hungUp(const int ms)
+    {
+        return !receive(ms) && !open();
+    }
+
+private:
+    bool receive(const int ms)
+    {
+        pollfd in{fd_, POLLIN, 0};
+        const int ready = ::poll(&in, 1, ms);
+
+        if(ready < 0 && errno != EINTR) closed_ = true;
+        if(ready <= 0) return ready == 0 || errno == EINTR;
+
+        char chunk[1024];
+        const ssize_t got = ::recv(fd_, chunk, sizeof(chunk), 0);
+
+        if(got < 0 && errno == EINTR) return true;
+
+        if(got <= 0 || pending_.size() > 4096u)
+        {
+            closed_ = true;
+            return false;
+        }
+
+        pending_.append(chunk, static_cast<std::size_t>(got));
+
+        return true;
+    }
+
+    int fd_ = -1;
+    bool closed_ = false;
+    std::string pending_;
+};
+
+/**
+ * The "key=value" field 'key' of a protocol line, or "" when absent.
+ */
+static std::string lineField(const std::string &line, const std::string &key)
+{
+    std::istringstream in(line);
+    std::string word;
+
+    while(in >> word)
+    {
+        if(word.size() > key.size() && word.compare(0, key.size(), key) == 0 && word[key.size()] == '=')
+        {
+            return word.substr(key.size() + 1u);
+        }
+    }
+
+    return "";
+}
+
+/**
+ * One RUN request: 'cycles' windows of 'windowMs', the first opening at 'startEpochNs'
+ * on the agent's own wall clock and each next one 'periodNs' later. Zero threads
+ * means every CPU the agent may use.
+ */
+struct AgentRun
+{
+    std::uint64_t startEpochNs = 0u;
+    std::uint64_t periodNs = 0u;
+    n_type cycles = 0u;
+    n_type windowMs = 0u;
+    unsigned threads = 1u;
+    std::string kernel;
+};
+
+static std::string renderAgentRun(const AgentRun &run)
+{
+    return "RUN start=" + std::to_string(run.startEpochNs) + " period-ns=" + std::to_string(run.periodNs)
+         + " cycles=" + std::to_string(run.cycles) + " window-ms=" + std::to_string(run.windowMs)
+         + " threads=" + (run.threads ? std::to_string(run.threads) : std::string("all")) + " kernel=" + run.kernel;
+}
+
+static bool parseAgentRun(const std::string &line, AgentRun &run, std::string &error)
+{
+    const std::string threads = lineField(line, "threads");
+    n_type number = 0u;
+
+    run.kernel = lineField(line, "kernel");
+
+    if(!parsePositive(lineField(line, "start"), run.startEpochNs) || !parsePositive(lineField(line, "period-ns"), run.periodNs)
+       || !parsePositive(lineField(line, "cycles"), run.cycles) || !parsePositive(lineField(line, "window-ms"), run.windowMs)
+       || run.kernel.empty() || (threads != "all" && !parsePositive(threads, number)))
+    {
+        error = "malformed RUN request";
+        return false;
+    }
+
+    run.threads = static_cast<unsigned>(std::min<n_type>(number, 4096u));
+
+    if(run.windowMs > maxWindowMs || run.cycles > 1000000u || run.periodNs < run.windowMs * 1000000u)
+    {
+        error = "RUN request out of range";
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Run one controller request: every window opens at its scheduled instant and is
+ * reported as soon as it closes. Stops early if the controller hangs up.
+ */
+static void runAgentCycles(LineSocket &channel, const std::string &peer, const ProbeSetup &base, const KernelInfo &kernel,
+                           const AgentRun &request, const std::vector<int> &allowedCpus, LogSink &logSink,
+                           ResultFormatter &formatter, const bool writeResults, ConsoleWriter &console)
+{
+    ProbeSetup setup = base;
+    setup.kernel = &kernel;
+    setup.windowNs = request.windowMs * 1000000u;
+    setup.threads = request.threads ? request.threads : static_cast<unsigned>(allowedCpus.size());
+
+    const Calibration calibration = calibrateCheckShift(setup.windowNs, kernel);
+    const double expectedSamples = static_cast<double>(setup.windowNs) / calibration.iterationNs / progressInterval;
+    setup.checkShift = calibration.checkShift;
+    setup.sampleCapacity = static_cast<std::size_t>(std::min(expectedSamples * 2.0, 4194304.0)) + 64u;
+
+    std::vector<int> cpus(setup.threads);
+    for(unsigned t = 0u; t < setup.threads; ++t) cpus[t] = allowedCpus[t % allowedCpus.size()];
+
+    std::ostringstream runLine;
+    runLine << "Agent run for " << peer << ": " << request.cycles << " cycles of " << formatWindow(request.windowMs)
+            << ", kernel " << kernel.name << ", " << setup.threads << " threads";
+
+    logSink.appendIteration(runLine.str() + "\t" + dateTimeToString(std::chrono::system_clock::now()) + "\n");
+
+    console.write(Verbosity::progress, runLine.str() + "\n");
+
+    n_type cycle = 1u;
+    bool hungUp = false;
+
+    for(; cycle <= request.cycles && !daemonStopRequested && !hungUp; ++cycle)
+    {
+        // The schedule is on the wall clock the controller synchronised against; the
+        // workers spin on the raw monotonic clock, so map the instant across once
+        const std::uint64_t targetEpochNs = request.startEpochNs + (cycle - 1u) * request.periodNs;
+        const std::uint64_t nowEpochNs = epochNs(std::chrono::system_clock::now());
+        const std::uint64_t nowRawNs = monotonicRawNs();
+        const std::uint64_t targetRawNs = (targetEpochNs > nowEpochNs) ? nowRawNs + (targetEpochNs - nowEpochNs) : 0u;
+
+        // Sleep until just before the instant, noticing a controller that went away
+        for(std::uint64_t rawNs = monotonicRawNs(); !daemonStopRequested && !hungUp && rawNs + agentSpinLeadNs < targetRawNs;
+            rawNs = monotonicRawNs())
+        {
+            hungUp = channel.hungUp(static_cast<int>(std::min<std::uint64_t>((targetRawNs - agentSpinLeadNs - rawNs) / 1000000u, 100u)));
+        }
+
+        if(daemonStopRequested || hungUp) break;
+
+        CycleWindow window;
+        window.checkShift = setup.checkShift;
+        window.sampleCapacity = setup.sampleCapacity;
+        window.kernel = setup.kernel;
+        window.perfCounters = setup.perfCounters;
+        window.engine = setup.engine->engine;
+        window.tsc = setup.tsc;
+
+        WindowRun run;
+        runCycleWindow(window, cpus, setup.windowNs, logSink, run, targetRawNs);
+
+        double opsPerSec = 0.0;
+        double mhz = 0.0;
+        sum_type iterations = 0u;
+
+        for(const WorkerResult &r : run.results)
+        {
+            opsPerSec += opsPerSecond(r);
+            mhz += r.cpuMhz / setup.threads;
+            iterations += r.iterations;
+        }
+
+        const std::uint64_t startEpochNs = epochNs(run.anchorSys) + (run.startNs - run.anchorRawNs);
+        const double lateUs = (static_cast<double>(startEpochNs) - static_cast<double>(targetEpochNs)) / 1000.0;
+
+        std::ostringstream reply;
+        reply.imbue(std::locale::classic());
+        reply << "CYCLE " << cycle << " start=" << startEpochNs << " elapsed-ns=" << run.results.front().elapsedNs
+              << " iterations=" << sumToString(iterations) << " ops=" << fixedText(opsPerSec, 1) << " mhz=" << fixedText(mhz, 1);
+
+        hungUp = !channel.sendLine(reply.str());
+
+        logSink.appendIteration("Agent cycle " + std::to_string(cycle) + "\t" + formatWithCommas(static_cast<n_type>(opsPerSec))
+                                + " ops/sec\tstart " + fixedText(lateUs, 1) + " us from schedule\n");
+
+        if(writeResults)
+        {
+            ResultRecord record;
+            record.record     = "agent";
+            record.cycle      = cycle;
+            record.threads    = setup.threads;
+            record.kernel     = kernel.name;
+            record.engine     = setup.engine->name;
+            record.isa        = kernel.isa;
+            record.startNs    = startEpochNs;
+            record.endNs      = startEpochNs + run.results.front().elapsedNs;
+            record.iterations = iterations;
+            record.opsPerSec  = opsPerSec;
+            record.cpuMhz     = mhz;
+            record.node       = peer;
+
+            logSink.appendResults(formatter.format(record));
+        }
+
+        console.write(Verbosity::progress, dateTimeToString(run.anchorSys) + " cycle " + std::to_string(cycle) + " of "
+                      + std::to_string(request.cycles) + " Ops/sec " + formatWithCommas(static_cast<n_type>(opsPerSec))
+                      + ", start " + fixedText(lateUs, 1) + " us from schedule\n");
+    }
+
+    if(!hungUp) channel.sendLine(cycle > request.cycles ? "DONE" : "ERROR agent stopping");
+}
+
+/**
+ * One controller connection: HELLO, TIME and RUN requests until QUIT, hang-up or
+ * 'agentIdleNs' without a request.
+ */
+static void serveController(LineSocket &channel, const std::string &peer, const ProbeSetup &base,
+                            const std::vector<int> &allowedCpus, LogSink &logSink, ResultFormatter &formatter,
+                            const bool writeResults, ConsoleWriter &console)
+{
+    std::uint64_t lastRequestNs = monotonicRawNs();
+    std::string line;
+
+    while(!daemonStopRequested && channel.open() && monotonicRawNs() - lastRequestNs < agentIdleNs)
+    {
+        if(!channel.readLine(line, monotonicRawNs() + 250000000u)) continue;
+
+        const std::string command = line.substr(0, line.find(' '));
+        lastRequestNs = monotonicRawNs();
+
+        if(command == "HELLO")
+        {
+            if(line != std::string("HELLO ") + clusterProtocol)
+            {
+                channel.sendLine(std::string("ERROR expected HELLO ") + clusterProtocol);
+                return;
+            }
+
+            channel.sendLine(std::string("HELLO ") + clusterProtocol + " host=" + hostName() + " cpus=" + std::to_string(allowedCpus.size()));
+        }
+        else if(command == "TIME")
+        {
+            channel.sendLine("TIME " + std::to_string(epochNs(std::chrono::system_clock::now())));
+        }
+        else if(command == "RUN")
+        {
+            AgentRun request;
+            std::string error;
+            const KernelInfo *kernel = nullptr;
+
+            if(parseAgentRun(line, request, error))
+            {
+                kernel = findKernel(request.kernel);
+
+                if(kernel == nullptr) error = "unknown kernel " + request.kernel;
+                else if(!kernel->supported()) error = "kernel " + request.kernel + " is not supported on this CPU";
+                else if(base.engine->engine == TimingEngine::legacySecond && (request.windowMs < 1000u || request.windowMs % 1000u))
+                {
+                    // Rounded up to whole seconds it would overrun the next scheduled window
+                    error = "engine legacy-second cannot time a " + formatWindow(request.windowMs) + " window";
+                }
+            }
+
+            if(!error.empty())
+            {
+                channel.sendLine("ERROR " + error);
+                continue;
+            }
+
+            channel.sendLine("OK");
+            runAgentCycles(channel, peer, base, *kernel, request, allowedCpus, logSink, formatter, writeResults, console);
+            lastRequestNs = monotonicRawNs();
+        }
+        else if(command == "QUIT")
+        {
+            return;
+        }
+        else
+        {
+            channel.sendLine("ERROR unknown request " + command);
+        }
+    }
+}
+
+/**
+ * --agent: serve controllers on 'listen', one connection at a time, until SIGINT or
+ * SIGTERM. Kernel, threads, window and schedule come from the controller; the timing
+ * engine and perf counters from this command line. Returns the exit code.
+ */
+static int runAgent(const ProbeSetup &base, const std::vector<int> &allowedCpus, const std::string &listen,
+                    LogSink &logSink, ResultFormatter &formatter, const bool writeResults, ConsoleWriter &console)
+{
+    std::string unixPath;
+    std::string error;
+    const int fd = listenSocket(listen, unixPath, error);
+
+    if(fd < 0)
+    {
+        std::cerr << "Cannot listen on " << listen << ": " << error << "\n";
+        return 1;
+    }
+
+    catchStopSignals();
+
+    n_type connections = 0u;
+
+    while(!daemonStopRequested)
+    {
+        pollfd listener{fd, POLLIN, 0};
+
+        if(::poll(&listener, 1, 250) <= 0) continue;
+
+        sockaddr_storage addr{};
+        socklen_t length = sizeof(addr);
+        const int client = ::accept4(fd, reinterpret_cast<sockaddr *>(&addr), &length, SOCK_CLOEXEC);
+
+        if(client < 0) continue;
+
+        char text[INET6_ADDRSTRLEN] = "local";
+        const int noDelay = 1;
+
+        if(addr.ss_family == AF_INET) ::inet_ntop(AF_INET, &reinterpret_cast<const sockaddr_in &>(addr).sin_addr, text, sizeof(text));
+        if(addr.ss_family == AF_INET6) ::inet_ntop(AF_INET6, &reinterpret_cast<const sockaddr_in6 &>(addr).sin6_addr, text, sizeof(text));
+        if(addr.ss_family != AF_UNIX) ::setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        const std::string peer = text;
+        LineSocket channel(client);
+        ++connections;
+
+        console.write(Verbosity::progress, dateTimeToString(std::chrono::system_clock::now()) + " controller " + peer + " connected\n");
+
+        serveController(channel, peer, base, allowedCpus, logSink, formatter, writeResults, console);
+
+        console.write(Verbosity::progress, dateTimeToString(std::chrono::system_clock::now()) + " controller " + peer + " done\n");
+    }
+
+    ::close(fd);
+    if(!unixPath.empty()) ::unlink(unixPath.c_str());
+
+    std::ostringstream itLog;
+    itLog << "Agent stopped " << dateTimeToString(std::chrono::system_clock::now()) << " after " << connections << " controller connections\n"
+          << std::string(33, '_') << "\n\n";
+    logSink.appendIteration(itLog.str());
+
+    if(writeResults) logSink.appendResults(formatter.footer());
+
+    return 0;
+}
+
+/**
+ * One agent as the controller sees it. 'offsetNs' is the agent's wall clock minus
+ * ours, from the fastest TIME round trip; cycle starts and skews are on our clock.
+ */
+struct ClusterNode
+{
+    struct Cycle
+    {
+        n_type cycle = 0u;
+        std::uint64_t startNs = 0u;
+        std::uint64_t elapsedNs = 0u;
+        sum_type iterations = 0u;
+        double opsPerSec = 0.0;
+        double cpuMhz = 0.0;
+        double skewUs = 0.0;
+    };
+
+    std::string address;
+    std::string host;
+    unsigned cpus = 0u;
+    std::unique_ptr<LineSocket> channel;
+    std::int64_t offsetNs = 0;
+    std::uint64_t rttNs = 0u;
+    std::vector<Cycle> cycles;
+    std::string error;
+
+    std::string label() const
+    {
+        return host.empty() ? address : host + " (" + address + ")";
+    }
+};
+
+/**
+ * Connect, check the protocol and estimate the clock offset from 'exchanges' TIME
+ * round trips. The fastest one bounds the agent's clock read most tightly, so its
+ * midpoint is used. False (with node.error set) if any step fails.
+ */
+static bool connectAgent(ClusterNode &node, const unsigned exchanges)
+{
+    std::string error;
+    const int fd = connectSocket(node.address, 5000, error);
+
+    if(fd < 0)
+    {
+        node.error = "cannot connect: " + error;
+        return false;
+    }
+
+    node.channel = std::make_unique<LineSocket>(fd);
+
+    const std::string hello = std::string("HELLO ") + clusterProtocol;
+    std::string line;
+
+    if(!node.channel->sendLine(hello) || !node.channel->readLine(line, monotonicRawNs() + 5000000000u))
+    {
+        node.error = "no reply to HELLO";
+        return false;
+    }
+
+    if(line.compare(0, hello.size(), hello) != 0)
+    {
+        node.error = "unexpected reply: " + line;
+        return false;
+    }
+
+    n_type cpus = 0u;
+    node.host = lineField(line, "host");
+    node.cpus = parsePositive(lineField(line, "cpus"), cpus) ? static_cast<unsigned>(cpus) : 0u;
+
+    for(unsigned k = 0u; k < exchanges; ++k)
+    {
+        const std::uint64_t sentNs = epochNs(std::chrono::system_clock::now());
+        n_type agentNs = 0u;
+
+        if(!node.channel->sendLine("TIME") || !node.channel->readLine(line, monotonicRawNs() + 5000000000u)
+           || line.compare(0, 5, "TIME ") != 0 || !parsePositive(line.substr(5), agentNs))
+        {
+            node.error = "no reply to TIME";
+            return false;
+        }
+
+        const std::uint64_t receivedNs = epochNs(std::chrono::system_clock::now());
+
+        if(receivedNs < sentNs) continue;
+
+        if(node.rttNs == 0u || receivedNs - sentNs < node.rttNs)
+        {
+            node.rttNs = std::max<std::uint64_t>(receivedNs - sentNs, 1u);
+            node.offsetNs = static_cast<std::int64_t>(agentNs) - static_cast<std::int64_t>(sentNs + (receivedNs - sentNs) / 2u);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * The per-node table and the cluster line: each cycle's cluster figure is the sum over
+ * the nodes, so only cycles every running node reported are counted.
+ */
+static std::string renderClusterSummary(const std::vector<ClusterNode> &nodes, const std::vector<double> &clusterOps,
+                                        const n_type cycles)
+{
+    std::ostringstream out;
+    out.imbue(userLocale());
+
+    n_type running = 0u;
+    for(const ClusterNode &node : nodes) running += node.cycles.empty() ? 0u : 1u;
+
+    out << "Cluster: " << running << " of " << nodes.size() << " nodes, " << cycles << " cycles\n"
+        << std::left << std::setw(36) << std::setfill(' ') << "Node" << std::right
+        << std::setw(8) << "Cycles" << std::setw(20) << "Mean ops/sec" << std::setw(8) << "CV %"
+        << std::setw(14) << "Max skew us" << std::setw(12) << "Offset ms" << "\n";
+
+    const ClusterNode *fastest = nullptr;
+    const ClusterNode *slowest = nullptr;
+    double fastestMean = 0.0;
+    double slowestMean = 0.0;
+
+    for(const ClusterNode &node : nodes)
+    {
+        std::vector<double> ops;
+        double maxSkewUs = 0.0;
+
+        for(const ClusterNode::Cycle &c : node.cycles)
+        {
+            ops.push_back(c.opsPerSec);
+            maxSkewUs = std::max(maxSkewUs, std::fabs(c.skewUs));
+        }
+
+        out << std::left << std::setw(36) << node.label() << std::right
+            << std::setw(8) << (std::to_string(node.cycles.size()) + "/" + std::to_string(cycles));
+
+        if(!ops.empty())
+        {
+            const CycleStats stats = computeCycleStats(ops);
+
+            out << std::setw(20) << formatWithCommas(static_cast<n_type>(stats.mean)) << std::setw(8) << fixedText(stats.cv * 100.0, 2)
+                << std::setw(14) << fixedText(maxSkewUs, 1) << std::setw(12) << fixedText(static_cast<double>(node.offsetNs) / 1e6, 3);
+
+            if(fastest == nullptr || stats.mean > fastestMean) { fastest = &node; fastestMean = stats.mean; }
+            if(slowest == nullptr || stats.mean < slowestMean) { slowest = &node; slowestMean = stats.mean; }
+        }
+
+        if(!node.error.empty()) out << "  failed: " << node.error;
+
+        out << "\n";
+    }
+
+    if(!clusterOps.empty())
+    {
+        const CycleStats stats = computeCycleStats(clusterOps);
+
+        out << "Cluster ops/sec (sum of nodes): mean " << formatWithCommas(static_cast<n_type>(stats.mean))
+            << ", min " << formatWithCommas(static_cast<n_type>(stats.min)) << ", max " << formatWithCommas(static_cast<n_type>(stats.max))
+            << ", CV " << fixedText(stats.cv * 100.0, 2) << "% over " << clusterOps.size() << " complete cycles\n";
+    }
+
+    if(fastest && slowest && fastest != slowest && fastestMean > 0.0)
+    {
+        out << "Node spread: slowest " << slowest->label() << " is " << fixedText((1.0 - slowestMean / fastestMean) * 100.0, 1)
+            << "% below fastest " << fastest->label() << "\n";
+    }
+
+    return out.str();
+}
+
+/**
+ * --controller: schedule the planned cycles on every agent at shared instants, collect
+ * what each reports and summarise the cluster. Returns 0 when every node finished.
+ */
+static int runController(const std::vector<std::string> &addresses, AgentRun plan, LogSink &logSink,
+                         ResultFormatter &formatter, const bool writeResults, ConsoleWriter &console)
+{
+    std::vector<ClusterNode> nodes(addresses.size());
+    std::uint64_t maxRttNs = 0u;
+
+    for(std::size_t k = 0u; k < addresses.size(); ++k)
+    {
+        nodes[k].address = addresses[k];
+
+        if(connectAgent(nodes[k], 8u)) maxRttNs = std::max(maxRttNs, nodes[k].rttNs);
+        else std::cerr << nodes[k].address << ": " << nodes[k].error << "\n";
+    }
+
+    // Every agent gets the same instants on its own clock; the gap between windows
+    // leaves room to report one cycle and to spin up for the next
+    const std::uint64_t windowNs = plan.windowMs * 1000000u;
+    const std::uint64_t leadNs = 2000000000u + 4u * maxRttNs;
+    const std::uint64_t sharedStartNs = (epochNs(std::chrono::system_clock::now()) + leadNs) / 1000000u * 1000000u;
+    plan.periodNs = windowNs + std::max<std::uint64_t>(200000000u, windowNs / 5u);
+
+    std::string line;
+
+    for(ClusterNode &node : nodes)
+    {
+        if(!node.error.empty()) continue;
+
+        AgentRun request = plan;
+        request.startEpochNs = static_cast<std::uint64_t>(static_cast<std::int64_t>(sharedStartNs) + node.offsetNs);
+
+        if(!node.channel->sendLine(renderAgentRun(request)) || !node.channel->readLine(line, monotonicRawNs() + 5000000000u))
+        {
+            node.error = "no reply to RUN";
+        }
+        else if(line != "OK")
+        {
+            node.error = line.compare(0, 6, "ERROR ") == 0 ? line.substr(6) : "unexpected reply: " + line;
+        }
+
+        if(!node.error.empty()) std::cerr << node.address << ": " << node.error << "\n";
+    }
+
+    {
+        std::ostringstream itLog;
+        itLog << "Controller: " << plan.cycles << " cycles of " << formatWindow(plan.windowMs) << " every "
+              << fixedText(static_cast<double>(plan.periodNs) / 1e6, 0) << " ms from " << dateTimeToString(std::chrono::system_clock::time_point(
+                     std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(sharedStartNs)))) << "\n";
+
+        for(const ClusterNode &node : nodes)
+        {
+            itLog << "Node: " << node.label();
+
+            if(node.error.empty())
+            {
+                itLog << ", " << node.cpus << " CPUs, clock offset " << fixedText(static_cast<double>(node.offsetNs) / 1e6, 3)
+                      << " ms, round trip " << fixedText(static_cast<double>(node.rttNs) / 1e6, 3) << " ms";
+            }
+            else
+            {
+                itLog << ", failed: " << node.error;
+            }
+
+            itLog << "\n";
+        }
+
+        logSink.appendIteration(itLog.str());
+    }
+
+    // Each node streams its cycles on its own connection; collect them concurrently
+    const std::uint64_t waitNs = sharedStartNs - std::min(sharedStartNs, epochNs(std::chrono::system_clock::now()))
+                               + plan.cycles * plan.periodNs + 30000000000u;
+    const std::uint64_t deadlineNs = monotonicRawNs() + waitNs;
+    std::vector<std::thread> collectors;
+
+    for(ClusterNode &node : nodes)
+    {
+        if(!node.error.empty()) continue;
+
+        collectors.emplace_back([&node, &plan, &console, sharedStartNs, deadlineNs]()
+        {
+            std::string reply;
+
+            while(node.error.empty())
+            {
+                if(!node.channel->readLine(reply, deadlineNs))
+                {
+                    node.error = node.channel->open() ? "timed out" : "connection lost";
+                    break;
+                }
+
+                if(reply == "DONE") break;
+
+                if(reply.compare(0, 6, "CYCLE ") != 0)
+                {
+                    node.error = reply.compare(0, 6, "ERROR ") == 0 ? reply.substr(6) : "unexpected reply: " + reply;
+                    break;
+                }
+
+                ClusterNode::Cycle c;
+                n_type agentStartNs = 0u;
+
+                c.cycle      = std::strtoull(reply.c_str() + 6, nullptr, 10);
+                c.elapsedNs  = std::strtoull(lineField(reply, "elapsed-ns").c_str(), nullptr, 10);
+                c.iterations = std::strtoull(lineField(reply, "iterations").c_str(), nullptr, 10);
+                c.opsPerSec  = std::strtod(lineField(reply, "ops").c_str(), nullptr);
+                c.cpuMhz     = std::strtod(lineField(reply, "mhz").c_str(), nullptr);
+
+                if(c.cycle < 1u || c.cycle > plan.cycles || !parsePositive(lineField(reply, "start"), agentStartNs))
+                {
+                    node.error = "malformed reply: " + reply;
+                    break;
+                }
+
+                // Back onto our clock, against this cycle's shared instant
+                c.startNs = static_cast<std::uint64_t>(static_cast<std::int64_t>(agentStartNs) - node.offsetNs);
+                c.skewUs  = (static_cast<double>(c.startNs) - static_cast<double>(sharedStartNs + (c.cycle - 1u) * plan.periodNs)) / 1000.0;
+                node.cycles.push_back(c);
+
+                console.write(Verbosity::progress, node.label() + " cycle " + std::to_string(c.cycle) + " of " + std::to_string(plan.cycles)
+                              + " Ops/sec " + formatWithCommas(static_cast<n_type>(c.opsPerSec)) + ", skew " + fixedText(c.skewUs, 1) + " us\n");
+            }
+
+            node.channel->sendLine("QUIT");
+        });
+    }
+
+    for(std::thread &collector : collectors) collector.join();
+
+    // Cluster throughput per cycle, over the cycles every running node reported
+    std::vector<double> clusterOps;
+    bool allFinished = true;
+
+    for(n_type cycle = 1u; cycle <= plan.cycles; ++cycle)
+    {
+        double total = 0.0;
+        bool complete = false;
+
+        for(const ClusterNode &node : nodes)
+        {
+            if(node.cycles.empty()) continue;
+
+            const auto found = std::find_if(node.cycles.begin(), node.cycles.end(),
+                                            [cycle](const ClusterNode::Cycle &c) { return c.cycle == cycle; });
+
+            if(found == node.cycles.end())
+            {
+                complete = false;
+                break;
+            }
+
+            total += found->opsPerSec;
+            complete = true;
+        }
+
+        if(complete) clusterOps.push_back(total);
+    }
+
+    for(const ClusterNode &node : nodes) allFinished = allFinished && node.error.empty();
+
+    const std::string summary = renderClusterSummary(nodes, clusterOps, plan.cycles);
+
+    console.write(Verbosity::summary, std::string(76, '=') + "\n" + summary);
+
+    logSink.appendIteration(summary + std::string(33, '_') + "\n\n");
+
+    if(writeResults)
+    {
+        for(const ClusterNode &node : nodes)
+        {
+            std::vector<double> ops;
+
+            for(const ClusterNode::Cycle &c : node.cycles)
+            {
+                ResultRecord record;
+                record.record     = "node";
+                record.cycle      = c.cycle;
+                record.threads    = plan.threads ? plan.threads : node.cpus;
+                record.kernel     = plan.kernel;
+                record.startNs    = c.startNs;
+                record.endNs      = c.startNs + c.elapsedNs;
+                record.iterations = c.iterations;
+                record.opsPerSec  = c.opsPerSec;
+                record.cpuMhz     = c.cpuMhz;
+                record.value      = c.skewUs;
+                record.unit       = "us start skew";
+                record.node       = node.address;
+                ops.push_back(c.opsPerSec);
+
+                logSink.appendResults(formatter.format(record));
+            }
+
+            if(ops.empty()) continue;
+
+            const CycleStats stats = computeCycleStats(ops);
+
+            ResultRecord record;
+            record.record    = "node-summary";
+            record.threads   = plan.threads ? plan.threads : node.cpus;
+            record.kernel    = plan.kernel;
+            record.opsPerSec = stats.mean;
+            record.stats     = &stats;
+            record.node      = node.address;
+            record.verdict   = node.error.empty() ? "ok" : "failed";
+
+            logSink.appendResults(formatter.format(record));
+        }
+
+        if(!clusterOps.empty())
+        {
+            const CycleStats stats = computeCycleStats(clusterOps);
+
+            ResultRecord record;
+            record.record    = "cluster";
+            record.kernel    = plan.kernel;
+            record.opsPerSec = stats.mean;
+            record.stats     = &stats;
+            record.verdict   = allFinished ? "ok" : "partial";
+
+            logSink.appendResults(formatter.format(record));
+        }
+
+        logSink.appendResults(formatter.footer());
+    }
+
+    return allFinished ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    // 0) Options: workers are pinned one per CPU whenever --threads is given. The user
+    // locale is loaded here so no rendering ever reads the locale database again
+    userLocale();
+    const std::vector<int> allowedCpus = getAllowedCpus();
+    Options opts;
+    bool showHelp = false;
+
+    if(!parseArguments(argc, argv, static_cast<unsigned>(allowedCpus.size()), opts, showHelp))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if(showHelp)
+    {
+        printUsage(argv[0]);
+        return 0;
+    }
+
+    if(!opts.exportDetail.empty())
+    {
+        return exportDetailLog(opts.exportDetail, opts.exportCycle, opts.exportDir);
+    }
+
+    if(opts.listKernels)
+    {
+        printKernels();
+        return 0;
+    }
+
+    const KernelInfo *kernel = findKernel(opts.kernel);
+
+    if(kernel == nullptr)
+    {
+        std::cerr << "Unknown kernel: " << opts.kernel << "\nAvailable kernels:\n";
+        printKernels();
+        return 1;
+    }
+
+    if(!kernel->supported())
+    {
+        std::cerr << "Kernel " << kernel->name << " is not supported on this CPU\n";
+        return 1;
+    }
+
+    const EngineInfo *engine = findEngine(opts.engine);
+
+    if(engine == nullptr || !engine->supported())
+    {
+        std::cerr << (engine ? "Engine not supported on this CPU: " : "Unknown engine: ") << opts.engine
+                  << "\nAvailable engines:\n";
+
+        for(const EngineInfo &candidate : engineRegistry)
+        {
+            std::cerr << "  " << std::left << std::setw(17) << std::setfill(' ') << candidate.name
+                      << (candidate.supported() ? "" : "[unsupported] ") << candidate.description << "\n";
+        }
+
+        return 1;
+    }
+
+    const bool defaultKernel = std::string(kernel->name) == "increment";
+    const bool memoryMode = opts.mode == "memory";
+    const bool c2cMode = opts.mode == "c2c";
+    const bool cpuMode = !memoryMode && !c2cMode;
+    const bool ciMode = opts.ciTarget > 0.0 && cpuMode;
+
+    if(opts.selfBenchmark) return runSelfBenchmark(*kernel, *engine, opts.durationMs);
+
+    // Daemon probes are short by default: 50 ms of every --interval-ms
+    if(opts.daemon && (!cpuMode || opts.ab || ciMode))
+    {
+        std::cerr << "--daemon runs CPU probes and cannot be combined with --mode memory|c2c, --ab or --ci-target\n";
+        return 1;
+    }
+
+    if(opts.daemon && !opts.durationGiven) opts.durationMs = 50u;
+
+    // legacy-second can only end a window on a wall-clock second boundary
+    const bool wholeSecondWindow = opts.durationMs >= 1000u && opts.durationMs % 1000u == 0u;
+
+    if(cpuMode && engine->engine == TimingEngine::legacySecond && !wholeSecondWindow)
+    {
+        std::cerr << "--engine legacy-second ends windows on wall-clock second boundaries and cannot time a "
+                  << formatWindow(opts.durationMs) << " window; use a whole number of seconds\n";
+        return 1;
+    }
+
+    // Sweep mode repeats the whole cycle loop once per thread count, workers pinned
+    const bool sweepMode = !opts.sweepThreads.empty();
+
+    if(sweepMode && (!cpuMode || opts.daemon || opts.threadsGiven))
+    {
+        std::cerr << "--sweep runs CPU cycles and cannot be combined with --mode memory|c2c, --daemon or --threads\n";
+        return 1;
+    }
+
+    if(opts.compareBaseline && (!cpuMode || opts.daemon))
+    {
+        std::cerr << "--compare-baseline compares CPU runs and cannot be combined with --mode memory|c2c or --daemon\n";
+        return 1;
+    }
+
+    // Cluster runs: an agent runs whatever a controller schedules, a controller only coordinates
+    const bool controllerMode = !opts.controllerAgents.empty();
+    const std::string agentListen = opts.listenGiven ? opts.listen : "127.0.0.1:9465";
+
+    if((opts.agent || controllerMode)
+       && ((opts.agent && controllerMode) || !cpuMode || opts.daemon || opts.ab || ciMode || sweepMode
+           || opts.compareBaseline || opts.telemetry || opts.unroll || opts.checkShift))
+    {
+        std::cerr << "--agent and --controller run plain CPU cycles and cannot be combined with each other, --mode memory|c2c,\n"
+                  << "--daemon, --ab, --ci-target, --sweep, --compare-baseline, --telemetry, --unroll or --check-shift\n";
+        return 1;
+    }
+
+    // Containers: a CFS quota caps the CPUs actually available, whatever the affinity mask
+    // says, so it sets the default thread count. Cluster runs take theirs from the controller
+    const CgroupCpu cgroup = detectCgroupCpu();
+    const unsigned quotaThreads = (cgroup.quotaCpus > 0.0)
+        ? std::min(static_cast<unsigned>(allowedCpus.size()), std::max(1u, static_cast<unsigned>(cgroup.quotaCpus)))
+        : 0u;
+    const bool cgroupThrottling = quotaThreads && !cgroup.statPath.empty();
+
+    // Workload profile: several kernels share the workers in every cycle, all pinned
+    WorkloadProfile profile;
+    const bool profileMode = !opts.profile.empty();
+
+    if(profileMode)
+    {
+        std::string error;
+
+        if(!loadProfile(opts.profile, profile, error))
+        {
+            std::cerr << "Invalid --profile " << opts.profile << ": " << error << "\n";
+            return 1;
+        }
+
+        if(!cpuMode || opts.daemon || opts.ab || sweepMode || opts.agent || controllerMode || opts.unroll || opts.checkShift
+           || engine->engine != TimingEngine::steadyDeadline)
+        {
+            std::cerr << "--profile runs CPU cycles on the steady-deadline engine and cannot be combined with --mode memory|c2c,\n"
+                      << "--daemon, --ab, --sweep, --agent, --controller, --unroll or --check-shift\n";
+            return 1;
+        }
+
+        if(!opts.threadsGiven)
+        {
+            opts.threads = profile.threads ? profile.threads : quotaThreads ? quotaThreads : static_cast<unsigned>(allowedCpus.size());
+        }
+
+        opts.threadsGiven = true;
+
+        if(opts.threads < profile.workloads.size())
+        {
+            std::cerr << "--profile " << opts.profile << " has " << profile.workloads.size() << " workloads but only "
+                      << opts.threads << " threads\n";
+            return 1;
+        }
+    }
+
+    if(!opts.threadsGiven && quotaThreads && cpuMode && !opts.agent && !controllerMode) opts.threads = quotaThreads;
+
+    const std::vector<unsigned> threadCounts = sweepMode ? opts.sweepThreads : std::vector<unsigned>{opts.threads};
+    unsigned threadCount = threadCounts.back();
+    const bool pinWorkers = opts.threadsGiven || sweepMode;
+    const bool interactive = !opts.cyclesGiven && opts.verbosity >= Verbosity::progress && !opts.daemon && !opts.agent;
+
+    // Console output goes through its own thread from here on; only summaries are never dropped
+    ConsoleWriter console(opts.verbosity, std::size_t(4) << 20);
+
+    if(threadCount > allowedCpus.size() && !controllerMode)
+    {
+        std::cerr << "Warning: " << threadCount << " threads on " << allowedCpus.size()
+                  << " CPUs; workers will share cores\n";
+    }
+    else if(cgroup.quotaCpus > 0.0 && threadCount > cgroup.quotaCpus && cpuMode && !controllerMode)
+    {
+        std::cerr << "Warning: " << threadCount << " threads on a CPU quota of " << fixedText(cgroup.quotaCpus, 2)
+                  << " CPUs; expect CFS throttling\n";
+    }
+
+    bool multiThreaded = threadCount > 1u;
+
+    // A/B mode: every other supported engine gets its own window in each cycle
+    const bool abMode = opts.ab && cpuMode;
+    std::vector<const EngineInfo *> abEngines;
+
+    for(const EngineInfo &other : engineRegistry)
+    {
+        if(!abMode || &other == engine || !other.supported()) continue;
+
+        if(other.engine == TimingEngine::legacySecond && !wholeSecondWindow)
+        {
+            std::cerr << "Warning: --ab leaves out legacy-second, which cannot time a " << formatWindow(opts.durationMs) << " window\n";
+            continue;
+        }
+
+        abEngines.push_back(&other);
+    }
+
+    bool usesTsc = engine->engine == TimingEngine::tsc;
+    for(const EngineInfo *other : abEngines) usesTsc = usesTsc || other->engine == TimingEngine::tsc;
+
+    // TSC timing is calibrated once; a counter that fails the checks is not used at all
+    TscClock tscClock;
+
+    if(usesTsc && cpuMode)
+    {
+        tscClock = calibrateTscClock();
+
+        if(!tscClock.usable)
+        {
+            std::cerr << "Warning: TSC timing unavailable (" << tscClock.reason << "); falling back to steady-deadline\n";
+
+            if(engine->engine == TimingEngine::tsc) engine = findEngine("steady-deadline");
+
+            abEngines.erase(std::remove_if(abEngines.begin(), abEngines.end(), [engine](const EngineInfo *other)
+            {
+                return other == engine || other->engine == TimingEngine::tsc;
+            }), abEngines.end());
+        }
+    }
+
+    const bool defaultEngine = engine->engine == TimingEngine::steadyDeadline;
+
+    std::vector<int> workerCpus;
+
+    // Core-to-core mode: every pair of these CPUs is measured, in list order
+    std::vector<int> c2cCpus;
+
+    if(c2cMode)
+    {
+        for(const int cpu : opts.c2cCpus.empty() ? allowedCpus : parseCpuList(opts.c2cCpus))
+        {
+            if(std::find(allowedCpus.begin(), allowedCpus.end(), cpu) == allowedCpus.end())
+            {
+                std::cerr << "CPU " << cpu << " in --c2c-cpus is not in this process's affinity mask\n";
+                return 1;
+            }
+
+            if(std::find(c2cCpus.begin(), c2cCpus.end(), cpu) == c2cCpus.end()) c2cCpus.push_back(cpu);
+        }
+
+        if(c2cCpus.size() < 2u)
+        {
+            std::cerr << "--mode c2c needs at least two CPUs, have " << c2cCpus.size() << "\n";
+            return 1;
+        }
+    }
+
+    // 1) Build directory paths
+    fs::path currentDir = opts.outputDir.empty() ? fs::current_path() : opts.outputDir;
+    fs::path logDetailDir = currentDir / "CycleLogDetail";
+    fs::path iterationDir = currentDir / "CycleLog";
+
+    // 2) Create directories if needed
+    fs::create_directories(logDetailDir);
+    fs::create_directories(iterationDir);
+
+    // 3) Verify existence
+    if(!fs::exists(logDetailDir) || !fs::exists(iterationDir))
+    {
+        std::cerr << "Directories do not exist\nMissing:\n";
+
+        if(!fs::exists(logDetailDir))  std::cerr << logDetailDir << "\n";
+        if(!fs::exists(iterationDir))  std::cerr << iterationDir << "\n";
+
+        return 1;
+    }
+
+    fs::path iterationLogPath = iterationDir / "Iteration.txt";
+
+    // --detail-format binary: one mmap-backed log for the run instead of a file per cycle.
+    // Declared before the sink so it outlives the sink's writer thread
+    const fs::path detailLogPath = logDetailDir / ("Detail " + getFileTimestamp() + ".cslog");
+    std::unique_ptr<DetailLog> detailLog;
+
+    if(opts.binaryDetail)
+    {
+        detailLog = std::make_unique<DetailLog>(detailLogPath);
+
+        if(!detailLog->good())
+        {
+            std::cerr << "Cannot create " << detailLogPath << "\n";
+            return 1;
+        }
+    }
+
+    // Iteration.txt stays open for the run; writes happen between windows on a background thread
+    LogSink logSink(iterationLogPath, std::size_t(1) << 20);
+
+    if(!logSink.good())
+    {
+        std::cerr << "Cannot open " << iterationLogPath << "\n";
+        return 1;
+    }
+
+    logSink.attachDetailLog(detailLog.get());
+    logSink.attachConsole(&console);
+
+    // Machine-readable records go through the same sink, one file per run
+    ResultFormatter formatter(opts.format, hostName());
+    const bool writeResults = opts.format != ResultFormat::none;
+
+    if(writeResults)
+    {
+        const fs::path resultsPath = opts.resultsFile.empty()
+            ? iterationDir / ("Results " + getFileTimestamp() + "." + ResultFormatter::extension(opts.format))
+            : opts.resultsFile;
+
+        if(!logSink.openResults(resultsPath))
+        {
+            std::cerr << "Cannot open " << resultsPath << "\n";
+            return 1;
+        }
+
+        logSink.appendResults(formatter.header());
+    }
+
+    // 4) Print banner and 5) get user input, unless running from the command line
+    n_type cycles = opts.cycles;
+
+    if(interactive)
+    {
+        console.write(Verbosity::summary, std::string(50, '*') + "\n"
+                      + "Gautier Iteration Test\n"
+                      + "Provides an informal assessment of operations per second on a given system\n"
+                      + "Essentially how fast can C++ code execute today\n"
+                      + "Helps in building better estimates for capacity planning and design\n"
+                      + std::string(50, '*') + "\n"
+                      + "How many times you want the test to run?\n"
+                      + "Type number then <enter>:  ");
+        console.drain();
+
+        std::cin >> cycles;
+
+        if(!std::cin.good() || cycles < 1)
+        {
+            std::cerr << "Invalid input; defaulting to 1.\n";
+            cycles = 1u;
+        }
+    }
+
+    {
+        std::ostringstream line;
+
+        if(opts.daemon)
+        {
+            line << "Daemon: " << opts.durationMs << " ms probe every " << opts.intervalMs << " ms on the idlest "
+                 << threadCount << " CPU(s), metrics on " << opts.listen;
+        }
+        else if(opts.agent)
+        {
+            line << "Agent: waiting for a controller on " << agentListen;
+        }
+        else if(controllerMode)
+        {
+            line << "Controller: " << cycles << " cycles of " << formatWindow(opts.durationMs) << " on "
+                 << opts.controllerAgents.size() << " agents, kernel " << kernel->name << ", "
+                 << (opts.threadsAll ? std::string("all") : std::to_string(threadCount)) << " threads per node";
+        }
+        else
+        {
+            line << "Running " << cycles << " test runs";
+
+            if(memoryMode) line << " in memory mode";
+            else if(c2cMode) line << " in core-to-core mode on " << c2cCpus.size() << " CPUs";
+            else if(sweepMode) line << " at each of " << threadCounts.size() << " thread counts up to " << threadCount;
+            else if(multiThreaded) line << " on " << threadCount << " threads";
+            if(cpuMode && !defaultKernel) line << " with kernel " << kernel->name << " (" << kernel->isa << ")";
+            if(cpuMode && !defaultEngine) line << " timed by " << engine->name;
+            if(cpuMode && engine->engine == TimingEngine::legacySecond)
+            {
+                line << ", windows of up to " << formatWindow(opts.durationMs) << " ending on a wall-clock second";
+            }
+            else if(cpuMode && opts.durationMs != 1000u) line << ", " << formatWindow(opts.durationMs) << " windows";
+            if(abMode) line << ", A/B against the other timing engines";
+            if(profileMode) line << ", workload mix " << profile.name;
+        }
+
+        console.write(Verbosity::progress, line.str() + "\n");
+    }
+
+    // Telemetry sampler: sysfs files are opened once here, windows only re-read them
+    std::unique_ptr<TelemetrySampler> telemetry;
+
+    if(opts.telemetry && cpuMode && !opts.daemon)
+    {
+        telemetry = std::make_unique<TelemetrySampler>();
+
+        console.write(Verbosity::progress, "Telemetry: " + telemetry->sources() + "\n");
+    }
+
+    if(quotaThreads && cpuMode && !controllerMode) console.write(Verbosity::progress, renderCgroupCpu(cgroup) + "\n");
+
+    // Append initial info to iteration log
+    {
+        std::ostringstream itLog;
+        itLog << std::string(33, '*') << "\n";
+
+        if(opts.daemon)
+        {
+            itLog << "Daemon: " << opts.durationMs << " ms every " << opts.intervalMs << " ms, metrics on " << opts.listen << "\t"
+                  << dateTimeToString(std::chrono::system_clock::now()) << "\n";
+        }
+        else if(opts.agent)
+        {
+            itLog << "Agent: listening on " << agentListen << "\t"
+                  << dateTimeToString(std::chrono::system_clock::now()) << "\n";
+        }
+        else
+        {
+            itLog << "Cycles: " << cycles << "\t"
+                  << dateTimeToString(std::chrono::system_clock::now()) << "\n";
+        }
+
+        if(controllerMode)
+        {
+            itLog << "Agents:";
+            for(const std::string &address : opts.controllerAgents) itLog << " " << address;
+            itLog << "\n";
+        }
+
+        if(memoryMode) itLog << "Mode: memory\n";
+        else if(c2cMode) itLog << "Mode: c2c, " << opts.c2cRoundTrips << " round trips per batch\n";
+        else if(sweepMode)
+        {
+            itLog << "Sweep: threads";
+            for(const unsigned count : threadCounts) itLog << " " << count;
+            itLog << "\n";
+        }
+        else if(multiThreaded && !opts.agent) itLog << "Threads: " << threadCount << "\n";
+        if(cpuMode && !opts.agent && engine->engine == TimingEngine::legacySecond)
+        {
+            itLog << "Window: up to " << formatWindow(opts.durationMs) << ", ending on a wall-clock second\n";
+        }
+        else if(cpuMode && !opts.agent && opts.durationMs != 1000u) itLog << "Window: " << formatWindow(opts.durationMs) << "\n";
+        if(cpuMode && !opts.agent && !defaultKernel) itLog << "Kernel: " << kernel->name << "\n";
+        if(cpuMode && !opts.agent) itLog << "ISA: " << kernel->isa << "\n";
+        if(cpuMode && (!defaultEngine || abMode)) itLog << "Engine: " << engine->name << "\n";
+
+        for(const EngineInfo *other : abEngines) itLog << "A/B engine: " << other->name << "\n";
+
+        if(telemetry) itLog << "Telemetry: " << telemetry->sources() << "\n";
+        if(cgroup.version && cpuMode && !controllerMode) itLog << renderCgroupCpu(cgroup) << "\n";
+        if(profileMode) itLog << "Profile: " << profile.name << " (" << opts.profile.string() << ")\n";
+
+        if(tscClock.usable)
+        {
+            itLog << "TSC: " << std::fixed << std::setprecision(3) << tscClock.ticksPerNs << " GHz invariant"
+                  << (tscClock.hasRdtscp ? ", rdtscp" : "") << "\n";
+        }
+
+        itLog << std::string(28, '*') << "\n";
+        logSink.appendIteration(itLog.str());
+    }
+
+    // Memory mode: placements (local and remote per NUMA node) and the L1-to-DRAM size sweep
+    const std::vector<NumaNode> numaNodes = getNumaNodes(allowedCpus);
+    const std::vector<MemoryPlacement> placements = memoryPlacements(numaNodes);
+    const std::size_t memMaxBytes = opts.memMaxMib
+        ? static_cast<std::size_t>(opts.memMaxMib) << 20
+        : std::max(lastLevelCacheBytes() * 4u, std::size_t(64) << 20);
+    const std::vector<std::size_t> memSizes = memorySweepSizes(memMaxBytes);
+    const std::uint64_t memTestNs = static_cast<std::uint64_t>(opts.memTestMs) * 1000000u;
+    std::map<MemorySummaryKey, MemorySummary> memSummary;
+
+    // One arena per placement, sized for the largest working set and faulted in once by
+    // the pinned worker that owns it; every size and cycle reuses it
+    const PageMode pageMode = (opts.hugePages == "off") ? PageMode::base
+                            : (opts.hugePages == "2m")  ? PageMode::huge2m
+                            : (opts.hugePages == "1g")  ? PageMode::huge1g
+                            : PageMode::thp;
+    std::vector<std::unique_ptr<MemoryArena>> memArenas(memoryMode ? placements.size() : 0u);
+
+    for(std::size_t p = 0u; p < memArenas.size(); ++p)
+    {
+        std::thread owner([&]()
+        {
+            if(placements[p].cpu >= 0) pinThreadToCpu(placements[p].cpu);
+
+            memArenas[p] = std::make_unique<MemoryArena>(memSizes.back(), placements[p].memNode, pageMode);
+            memArenas[p]->firstTouch();
+        });
+
+        owner.join();
+
+        const MemoryArena &arena = *memArenas[p];
+        std::ostringstream line;
+        line << "Memory arena CPU node " << placements[p].cpuNode << " memory node " << placements[p].memNode << ": "
+             << formatBytes(arena.length()) << " on " << pageModeName(arena.pages()) << ", "
+             << formatBytes(arena.hugeBytes()) << " huge, first touch " << fixedText(arena.touchNs() / 1e6, 1) << " ms";
+        if(arena.pages() != pageMode) line << " (" << pageModeName(pageMode) << " unavailable)";
+
+        console.write(Verbosity::progress, line.str() + "\n");
+        logSink.appendIteration(line.str() + "\n");
+    }
+
+    // Core-to-core mode: per-pair latency summed over cycles for the mean matrix
+    std::vector<std::vector<double>> c2cSum(c2cCpus.size(), std::vector<double>(c2cCpus.size(), 0.0));
+
+    // Deadline-check interval and room for progress samples, sized once up front
+    const std::uint64_t windowNs = static_cast<std::uint64_t>(opts.durationMs) * 1000000u;
+    const Calibration calibration = cpuMode ? calibrateCheckShift(windowNs, *kernel) : Calibration{};
+    // In-window harness costs, timed briefly so the summary can put a figure on them
+    const HarnessCosts harnessCosts = cpuMode ? measureHarnessCosts(tscClock, 2000000u, false) : HarnessCosts{};
+    // Compiled variant: --unroll and/or --check-shift pick a loop from the matrix; an
+    // omitted check shift is the compiled one nearest the calibrated value
+    const VariantInfo *variant = nullptr;
+
+    if(cpuMode && (opts.unroll || opts.checkShift))
+    {
+        const unsigned unroll = opts.unroll ? opts.unroll : 1u;
+        unsigned shift = opts.checkShift;
+
+        const auto distance = [&calibration](const unsigned candidate)
+        {
+            return (candidate > calibration.checkShift) ? candidate - calibration.checkShift : calibration.checkShift - candidate;
+        };
+
+        for(const VariantInfo &candidate : variantRegistry)
+        {
+            if(!opts.checkShift && (!shift || distance(candidate.checkShift) < distance(shift))) shift = candidate.checkShift;
+        }
+
+        if(engine->engine != TimingEngine::steadyDeadline || abMode)
+        {
+            std::cerr << "Compiled variants (--unroll, --check-shift) run on the steady-deadline engine without --ab\n";
+            return 1;
+        }
+
+        variant = findVariant(kernel->name, unroll, shift);
+
+        if(variant == nullptr)
+        {
+            std::cerr << "No compiled variant for kernel " << kernel->name << ", unroll " << unroll << ", check shift " << shift
+                      << "\nCompiled: unroll 1|4|8, check shift 10|14|18, kernels";
+
+            for(const VariantInfo &candidate : variantRegistry)
+            {
+                if(candidate.unroll == 1u && candidate.checkShift == 10u) std::cerr << " " << candidate.kernel;
+            }
+
+            std::cerr << "\n";
+            return 1;
+        }
+
+        console.write(Verbosity::progress, "Using compiled variant unroll " + std::to_string(variant->unroll)
+                      + ", check every 2^" + std::to_string(variant->checkShift) + "\n");
+    }
+
+    const unsigned checkShift = variant ? variant->checkShift : calibration.checkShift;
+    const std::string variantName = variant
+        ? "u" + std::to_string(variant->unroll) + "c" + std::to_string(variant->checkShift) : "";
+    double fastestIterationNs = calibration.iterationNs;
+
+    for(Workload &w : profile.workloads)
+    {
+        w.calibration = calibrateCheckShift(windowNs, *w.kernel);
+        fastestIterationNs = std::min(fastestIterationNs, w.calibration.iterationNs);
+    }
+
+    const double expectedSamples = static_cast<double>(windowNs) / fastestIterationNs / progressInterval;
+    const std::size_t sampleCapacity = static_cast<std::size_t>(std::min(expectedSamples * 2.0, 4194304.0)) + 64u;
+
+    // Daemon mode replaces the cycle loop entirely
+    if(opts.daemon)
+    {
+        MetricsServer metrics(opts.listen);
+
+        if(!metrics.good())
+        {
+            std::cerr << "Cannot listen on " << opts.listen << ": " << metrics.error() << "\n";
+            return 1;
+        }
+
+        ProbeSetup setup;
+        setup.kernel = kernel;
+        setup.engine = engine;
+        setup.tsc = &tscClock;
+        setup.variant = variant;
+        setup.checkShift = checkShift;
+        setup.sampleCapacity = sampleCapacity;
+        setup.windowNs = windowNs;
+        setup.threads = threadCount;
+        setup.perfCounters = opts.perfCounters;
+
+        return runDaemon(setup, allowedCpus, opts.intervalMs, static_cast<std::size_t>(opts.rollingProbes),
+                         metrics, logSink, formatter, writeResults, console);
+    }
+
+    // Agent mode: each controller request brings its own kernel, threads and schedule
+    if(opts.agent)
+    {
+        ProbeSetup base;
+        base.engine = engine;
+        base.tsc = &tscClock;
+        base.perfCounters = opts.perfCounters;
+
+        return runAgent(base, allowedCpus, agentListen, logSink, formatter, writeResults, console);
+    }
+
+    // Controller mode: the cycles run on the agents, this host only schedules and summarises
+    if(controllerMode)
+    {
+        AgentRun plan;
+        plan.cycles = cycles;
+        plan.windowMs = opts.durationMs;
+        plan.threads = opts.threadsAll ? 0u : threadCount;
+        plan.kernel = kernel->name;
+
+        return runController(opts.controllerAgents, plan, logSink, formatter, writeResults, console);
+    }
+
+    // Baseline history: every CPU run is stored under host, CPU model, kernel and threads
+    BaselineDb baselineDb(opts.baselineDb.empty() ? iterationDir / "Baseline.db" : opts.baselineDb);
+    const std::string baselineHost = hostName();
+    const std::string cpuModel = cpuModelName();
+    const std::string kernelLabel = profileMode ? "profile:" + profile.name
+        : variantName.empty() ? std::string(kernel->name) : std::string(kernel->name) + "/" + variantName;
+    bool regressed = false;
+
+    // Each --sweep thread count gets the full cycle loop and summary (a single pass without --sweep)
+    const n_type plannedCycles = cycles;
+    std::vector<ScalingPoint> scaling;
+
+    for(const unsigned pointThreads : threadCounts)
+    {
+        threadCount = pointThreads;
+        multiThreaded = threadCount > 1u;
+        cycles = plannedCycles;
+        workerCpus.assign(threadCount, -1);
+
+        for(unsigned t = 0u; pinWorkers && t < threadCount; ++t)
+        {
+            workerCpus[t] = allowedCpus[t % allowedCpus.size()];
+        }
+
+        if(sweepMode)
+        {
+            console.write(Verbosity::progress, std::string(76, '=') + "\nSweep: " + std::to_string(threadCount) + " threads\n");
+
+            logSink.appendIteration("Sweep point: " + std::to_string(threadCount) + " threads\n");
+        }
+
+        // Profile: workers split by share, then each workload alone on its own CPUs for
+        // the solo figures the mixed cycles are compared against
+        const std::vector<WorkerMix> mix = profileMode ? assignWorkloads(profile, threadCount) : std::vector<WorkerMix>();
+        std::vector<std::vector<double>> workloadOps(profile.workloads.size());
+        std::vector<double> soloOps;
+
+        if(profileMode)
+        {
+            std::ostringstream split;
+            split << "Workload mix " << profile.name << ":";
+
+            for(const Workload &w : profile.workloads)
+            {
+                split << " " << w.name << (w.name == w.kernel->name ? "" : "=" + std::string(w.kernel->name)) << " x" << w.threads << (w.dutyPct < 100u ? " @" + std::to_string(w.dutyPct) + "%" : "");
+            }
+
+            console.write(Verbosity::progress, split.str() + "\n");
+            logSink.appendIteration(split.str() + "\n");
+        }
+
+        for(std::size_t k = 0u, first = 0u; profileMode && profile.solo && k < profile.workloads.size(); first += profile.workloads[k++].threads)
+        {
+            CycleWindow window;
+            window.sampleCapacity = sampleCapacity;
+            window.kernel = kernel;
+            window.warmupNs = static_cast<std::uint64_t>(opts.warmupMs) * 1000000u;
+            window.tsc = &tscClock;
+            window.mix = mix.data() + first;
+
+            WindowRun run;
+            const std::vector<int> cpus(workerCpus.begin() + static_cast<std::ptrdiff_t>(first),
+                                        workerCpus.begin() + static_cast<std::ptrdiff_t>(first + profile.workloads[k].threads));
+            runCycleWindow(window, cpus, windowNs, logSink, run);
+
+            soloOps.push_back(0.0);
+            for(const WorkerResult &r : run.results) soloOps.back() += opsPerSecond(r);
+
+            const std::string line = "Solo " + profile.workloads[k].name + " Ops/sec " + formatWithCommas(static_cast<n_type>(soloOps.back()));
+            console.write(Verbosity::progress, line + "\n");
+            logSink.appendIteration(line + "\n");
+        }
+
+        // For final summary; per-cycle ops/sec kept for the distribution statistics
+        sum_type sumOfIterations = 0u;
+        double sumOfOpsPerSec = 0.0;
+        std::vector<double> cycleOps;
+        cycleOps.reserve(std::max(cycles, ciMode ? opts.maxCycles : cycles));
+
+        bool converged = false;
+        double ciHalfWidth = 1.0;
+        bool perfWarned = false;
+        Telemetry runTelemetry;
+        n_type frequencyWindows = 0u;
+        CgroupThrottle runThrottle;
+        n_type throttledCycles = 0u;
+        double harnessNs = 0.0;
+        std::uint64_t workerNs = 0u;
+        runThrottle.valid = cgroupThrottling;
+        std::vector<std::vector<double>> abOps(abEngines.size());
+        const auto cycleStartTime = std::chrono::system_clock::now();
+
+        // 6) Loop over cycles
+        for(n_type cycle = 1u; cycle <= cycles; ++cycle)
+        {
+            if(console.shows(Verbosity::full))
+            {
+                std::ostringstream header;
+                header << std::string(76, '*') << "\n";
+                header << "Running Cycle "
+                       << std::setw(2) << std::setfill('0') << cycle
+                       << " of "
+                       << std::setw(2) << std::setfill('0') << cycles << "\n";
+                header << std::string(44, '*') << "\n";
+                console.write(Verbosity::full, header.str());
+            }
+
+            // Build detail file name
+            std::ostringstream fname;
+
+            fname << "T " << getFileTimestamp() << " "
+                  << std::setw(2) << std::setfill('0') << cycles << " - "
+                  << std::setw(2) << std::setfill('0') << cycle << ".txt";
+
+            fs::path detailFilePath = logDetailDir / fname.str();
+
+            // We'll collect log lines in a buffer (like StringBuilder in C#)
+            std::ostringstream buffer;
+
+            const auto nowTp = std::chrono::system_clock::now();
+            const std::string nowStr = dateTimeToString(nowTp);
+
+            console.write(Verbosity::full, "Ready to go ... " + nowStr + "\n");
+
+            std::string startStr;
+            std::string endStr;
+            std::ostringstream itLines;
+
+            if(memoryMode)
+            {
+                // 9) Memory sweep: one pinned worker per placement, all sizes and tests
+                startStr = dateTimeToString(std::chrono::system_clock::now());
+
+                std::vector<MemoryResult> memResults;
+
+                logSink.beginWindow();
+
+                for(std::size_t p = 0u; p < placements.size(); ++p)
+                {
+                    std::thread worker([&]()
+                    {
+                        if(placements[p].cpu >= 0) pinThreadToCpu(placements[p].cpu);
+
+                        runMemorySweep(placements[p], *memArenas[p], memSizes, memTestNs, memResults);
+                    });
+
+                    worker.join();
+                }
+
+                logSink.endWindow();
+
+                endStr = dateTimeToString(std::chrono::system_clock::now());
+
+                // 10) Results: GB/s for STREAM tests, ns/access for latency
+                for(const MemoryResult &r : memResults)
+                {
+                    const bool latency = r.test == memoryLatencyTest;
+                    std::ostringstream value;
+                    value << std::fixed << std::setprecision(latency ? 2 : 3) << r.value;
+
+                    buffer << "Memory " << std::left << std::setw(8) << std::setfill(' ') << memoryTests[r.test] << std::right
+                           << std::setw(8) << formatBytes(r.bytes)
+                           << " CPU node " << r.placement.cpuNode << " memory node " << r.placement.memNode
+                           << (r.bound || r.placement.memNode < 0 ? "" : " (unbound)")
+                           << " " << value.str() << (latency ? " ns/access" : " GB/s") << "\n";
+
+                    itLines << memoryTests[r.test] << "\t" << r.bytes << "\t" << r.placement.cpuNode << "\t" << r.placement.memNode
+                            << "\t" << value.str() << (latency ? " ns/access" : " GB/s") << "\n";
+
+                    if(writeResults)
+                    {
+                        ResultRecord record;
+                        record.record  = "memory";
+                        record.cycle   = cycle;
+                        record.cpu     = r.placement.cpu;
+                        record.test    = memoryTests[r.test];
+                        record.bytes   = r.bytes;
+                        record.cpuNode = r.placement.cpuNode;
+                        record.memNode = r.placement.memNode;
+                        record.value   = r.value;
+                        record.unit    = latency ? "ns/access" : "GB/s";
+                        logSink.appendResults(formatter.format(record));
+                    }
+
+                    MemorySummary &entry = memSummary[MemorySummaryKey(r.placement.cpuNode, r.placement.memNode, r.bytes)];
+                    entry.sum[r.test] += r.value;
+                    entry.count[r.test] += 1u;
+                }
+
+                buffer << "Memory sweep Start " << startStr << " ... End " << endStr << "\n";
+            }
+            else if(c2cMode)
+            {
+                // 9) Core-to-core: one cache line bounced between every pair of CPUs in turn
+                startStr = dateTimeToString(std::chrono::system_clock::now());
+
+                logSink.beginWindow();
+                const std::vector<std::vector<double>> matrix = measureCoreLatency(c2cCpus, opts.c2cRoundTrips);
+                logSink.endWindow();
+
+                endStr = dateTimeToString(std::chrono::system_clock::now());
+
+                // 10) Results: one-way latency per pair, plus the spread across pairs
+                double minNs = 1e300;
+                double maxNs = 0.0;
+                double sumNs = 0.0;
+                std::size_t pairs = 0u;
+
+                for(std::size_t a = 0u; a < c2cCpus.size(); ++a)
+                {
+                    for(std::size_t b = 0u; b < c2cCpus.size(); ++b)
+                    {
+                        c2cSum[a][b] += matrix[a][b];
+
+                        if(b <= a) continue;
+
+                        minNs = std::min(minNs, matrix[a][b]);
+                        maxNs = std::max(maxNs, matrix[a][b]);
+                        sumNs += matrix[a][b];
+                        ++pairs;
+
+                        if(writeResults)
+                        {
+                            ResultRecord record;
+                            record.record  = "c2c";
+                            record.cycle   = cycle;
+                            record.cpu     = c2cCpus[a];
+                            record.peerCpu = c2cCpus[b];
+                            record.value   = matrix[a][b];
+                            record.unit    = "ns";
+                            logSink.appendResults(formatter.format(record));
+                        }
+                    }
+                }
+
+                buffer << "Core-to-core one-way latency (ns)\n" << renderLatencyMatrix(c2cCpus, matrix)
+                       << "C2C min " << fixedText(minNs, 1) << " mean " << fixedText(sumNs / pairs, 1)
+                       << " max " << fixedText(maxNs, 1) << " ns over " << pairs << " pairs\n"
+                       << "C2C Start " << startStr << " ... End " << endStr << "\n";
+
+                itLines << "C2C\t" << fixedText(minNs, 1) << "\t" << fixedText(sumNs / pairs, 1) << "\t" << fixedText(maxNs, 1) << " ns\n";
+            }
+            else
+            {
+                // 9) Start measuring iteration on every worker in lockstep. With --ab the other
+                // engines get a window each as well, in an order that rotates every cycle
+                std::vector<std::size_t> order(abEngines.size() + 1u);
+                for(std::size_t k = 0u; k < order.size(); ++k) order[k] = k;
+                std::rotate(order.begin(), order.begin() + static_cast<std::ptrdiff_t>((cycle - 1u) % order.size()), order.end());
+
+                std::vector<WindowRun> runs(order.size());
+                CgroupThrottle cycleThrottle;
+
+                for(const std::size_t k : order)
+                {
+                    CycleWindow window;
+                    window.checkShift = checkShift;
+                    window.sampleCapacity = sampleCapacity;
+                    window.kernel = kernel;
+                    window.warmupNs = static_cast<std::uint64_t>(opts.warmupMs) * 1000000u;
+                    window.perfCounters = opts.perfCounters;
+                    window.engine = (k == 0u) ? engine->engine : abEngines[k - 1u]->engine;
+                    window.tsc = &tscClock;
+                    window.variant = variant;
+                    window.telemetry = (k == 0u) ? telemetry.get() : nullptr;
+                    window.mix = mix.empty() ? nullptr : mix.data();
+
+                    const CgroupThrottle throttleBefore = (k == 0u && cgroupThrottling) ? readCgroupThrottle(cgroup) : CgroupThrottle();
+
+                    runCycleWindow(window, workerCpus, windowNs, logSink, runs[k]);
+
+                    if(k == 0u && cgroupThrottling) cycleThrottle = cgroupThrottleDelta(throttleBefore, readCgroupThrottle(cgroup));
+                }
+
+                std::vector<WorkerResult> &results = runs[0].results;
+                const auto anchorSys = runs[0].anchorSys;
+                const std::uint64_t anchorRawNs = runs[0].anchorRawNs;
+                startStr = dateTimeToString(runs[order.front()].anchorSys);
+
+                n_type iterations = 0u;
+                double cycleOpsPerSec = 0.0;
+
+                for(unsigned t = 0u; opts.warmupMs > 0u && t < threadCount; ++t)
+                {
+                    if(multiThreaded) buffer << "Thread " << t << " ";
+
+                    buffer << "Warmed up for " << results[t].warmupNs / 1000000u << "ms"
+                           << (results[t].warmupStable ? "" : " (rate not yet stable)") << "\n";
+                }
+
+                for(unsigned t = 0u; t < threadCount; ++t)
+                {
+                    iterations += results[t].iterations;
+                    cycleOpsPerSec += opsPerSecond(results[t]);
+                    renderProgress(buffer, results[t], cycle, cycles, t, multiThreaded, anchorSys, anchorRawNs);
+
+                    const unsigned workerShift = mix.empty() ? checkShift : mix[t].checkShift;
+                    harnessNs += harnessOverheadPct(harnessCosts, engine->engine, results[t].iterations, workerShift, results[t].elapsedNs)
+                               * static_cast<double>(results[t].elapsedNs) / 100.0;
+                    workerNs += results[t].elapsedNs;
+                }
+
+                sumOfIterations += iterations;
+                sumOfOpsPerSec += cycleOpsPerSec;
+                cycleOps.push_back(cycleOpsPerSec);
+
+                const auto realEndSys = std::chrono::system_clock::now();
+                endStr = dateTimeToString(realEndSys);
+
+                // 10) Print iteration results to console
+                if(multiThreaded || opts.durationMs != 1000u)
+                {
+                    for(unsigned t = 0u; multiThreaded && t < threadCount; ++t)
+                    {
+                        buffer << "Thread " << t << " CPU " << results[t].cpu
+                               << (results[t].pinned ? "" : " (unpinned)")
+                               << " Iterations " << formatWithCommas(results[t].iterations)
+                               << " Ops/sec " << formatWithCommas(static_cast<n_type>(opsPerSecond(results[t]))) << "\n";
+                    }
+
+                    buffer << "Aggregate Ops/sec " << formatWithCommas(static_cast<n_type>(cycleOpsPerSec)) << "\n";
+                }
+
+                // Profile: throughput per workload, summed over its workers
+                std::vector<double> mixOps(profile.workloads.size(), 0.0);
+
+                for(unsigned t = 0u; t < mix.size(); ++t) mixOps[mix[t].workload] += opsPerSecond(results[t]);
+
+                for(std::size_t k = 0u; k < mixOps.size(); ++k)
+                {
+                    const Workload &w = profile.workloads[k];
+
+                    buffer << "Workload " << w.name << " (" << w.kernel->name << ", " << w.threads << " threads"
+                           << (w.dutyPct < 100u ? ", " + std::to_string(w.dutyPct) + "% duty" : "") << ") Ops/sec "
+                           << formatWithCommas(static_cast<n_type>(mixOps[k])) << "\n";
+                    itLines << "Workload\t" << w.name << "\t" << fixedText(mixOps[k], 0) << "\n";
+                    workloadOps[k].push_back(mixOps[k]);
+
+                    if(!writeResults) continue;
+
+                    ResultRecord record;
+                    record.record    = "workload";
+                    record.cycle     = cycle;
+                    record.threads   = w.threads;
+                    record.kernel    = w.kernel->name;
+                    record.engine    = engine->name;
+                    record.isa       = w.kernel->isa;
+                    record.startNs   = epochNs(anchorSys) + (runs[0].startNs - anchorRawNs);
+                    record.endNs     = record.startNs + windowNs;
+                    record.opsPerSec = mixOps[k];
+                    record.workload  = w.name;
+                    logSink.appendResults(formatter.format(record));
+                }
+
+                if(!defaultKernel && !profileMode) buffer << "Kernel " << kernel->name << " ISA " << kernel->isa << "\n";
+                if(variant) buffer << "Variant " << variantName << "\n";
+
+                buffer << "Iterations " << formatWithCommas(iterations)
+                       << " Start " << startStr
+                       << " ... End " << endStr << "\n";
+
+                itLines << iterations << "\n";
+
+                // Counter lines, with a one-off note when perf_event_open was refused
+                for(unsigned t = 0u; opts.perfCounters && t < threadCount; ++t)
+                {
+                    if(!results[t].perfOpened)
+                    {
+                        if(!perfWarned)
+                        {
+                            std::cerr << "Warning: perf counters unavailable (" << std::strerror(results[t].perfError)
+                                      << "); check /proc/sys/kernel/perf_event_paranoid\n";
+                            perfWarned = true;
+                        }
+
+                        continue;
+                    }
+
+                    const std::string perfLine = renderPerfCounts(results[t].perf, results[t].iterations);
+
+                    if(multiThreaded) buffer << "Thread " << t << " ";
+                    buffer << perfLine << "\n";
+
+                    if(multiThreaded) itLines << "Thread " << t << "\t";
+                    itLines << perfLine << "\n";
+                }
+
+                // Telemetry: perf cycles give the true effective clock when they ran on every worker
+                Telemetry &cycleTelemetry = runs[0].telemetry;
+
+                if(telemetry)
+                {
+                    double cyclesPerNs = 0.0;
+                    bool allCounted = opts.perfCounters;
+
+                    for(unsigned t = 0u; allCounted && t < threadCount; ++t)
+                    {
+                        allCounted = results[t].perfOpened && results[t].perf.hasHardware && results[t].elapsedNs > 0u;
+                        if(allCounted) cyclesPerNs += static_cast<double>(results[t].perf.cycles) / results[t].elapsedNs;
+                    }
+
+                    if(allCounted)
+                    {
+                        cycleTelemetry.hasFrequency = true;
+                        cycleTelemetry.ghz = cyclesPerNs / threadCount;
+                    }
+
+                    if(cycleTelemetry.hasEnergy && cycleTelemetry.joules > 0.0)
+                    {
+                        cycleTelemetry.opsPerJoule = static_cast<double>(iterations) / cycleTelemetry.joules;
+                    }
+
+                    mergeTelemetry(runTelemetry, frequencyWindows, cycleTelemetry);
+
+                    const std::string telemetryLine = renderTelemetry(cycleTelemetry);
+                    buffer << telemetryLine << "\n";
+                    itLines << telemetryLine << "\n";
+                }
+
+                // CFS throttling while the selected engine's window ran
+                if(cycleThrottle.valid)
+                {
+                    runThrottle.periods += cycleThrottle.periods;
+                    runThrottle.throttled += cycleThrottle.throttled;
+                    runThrottle.throttledMs += cycleThrottle.throttledMs;
+                    throttledCycles += cycleThrottle.throttled > 0u;
+
+                    const std::string throttleLine = renderCgroupThrottle(cycleThrottle);
+                    buffer << throttleLine << "\n";
+                    itLines << throttleLine << "\n";
+                }
+
+                // One record per worker; raw window stamps mapped onto epoch time
+                for(unsigned t = 0u; writeResults && t < threadCount; ++t)
+                {
+                    ResultRecord record;
+                    record.cycle      = cycle;
+                    record.thread     = static_cast<int>(t);
+                    record.cpu        = results[t].lastCpu;
+                    record.kernel     = mix.empty() ? kernel->name : mix[t].kernel->name;
+                    record.engine     = engine->name;
+                    record.variant    = variantName;
+                    record.isa        = mix.empty() ? kernel->isa : mix[t].kernel->isa;
+                    record.startNs    = epochNs(anchorSys) + (runs[0].startNs - anchorRawNs);
+                    record.endNs      = record.startNs + results[t].elapsedNs;
+                    record.iterations = results[t].iterations;
+                    record.opsPerSec  = opsPerSecond(results[t]);
+                    record.cpuMhz     = results[t].cpuMhz;
+                    record.perf       = results[t].perfOpened ? &results[t].perf : nullptr;
+                    record.telemetry  = telemetry ? &cycleTelemetry : nullptr;
+                    record.cgroup     = &cycleThrottle;
+                    logSink.appendResults(formatter.format(record));
+                }
+
+                if(multiThreaded)
+                {
+                    for(unsigned t = 0u; t < threadCount; ++t)
+                    {
+                        itLines << "Thread " << t << "\t" << results[t].cpu << "\t"
+                                << results[t].iterations << "\n";
+                    }
+                }
+
+                // A/B windows: aggregate only, normalized by each window's own length
+                for(std::size_t k = 1u; k < runs.size(); ++k)
+                {
+                    const EngineInfo &other = *abEngines[k - 1u];
+                    n_type otherIterations = 0u;
+                    double otherOpsPerSec = 0.0;
+
+                    if(k == 1u)
+                    {
+                        buffer << "Engine " << engine->name << " Ops/sec " << formatWithCommas(static_cast<n_type>(cycleOpsPerSec)) << "\n";
+                    }
+
+                    for(unsigned t = 0u; t < threadCount; ++t)
+                    {
+                        const WorkerResult &r = runs[k].results[t];
+                        otherIterations += r.iterations;
+                        otherOpsPerSec += opsPerSecond(r);
+
+                        if(!writeResults) continue;
+
+                        ResultRecord record;
+                        record.record     = "ab";
+                        record.cycle      = cycle;
+                        record.thread     = static_cast<int>(t);
+                        record.cpu        = r.lastCpu;
+                        record.kernel     = kernel->name;
+                        record.engine     = other.name;
+                        record.startNs    = epochNs(runs[k].anchorSys) + (runs[k].startNs - runs[k].anchorRawNs);
+                        record.endNs      = record.startNs + r.elapsedNs;
+                        record.iterations = r.iterations;
+                        record.opsPerSec  = opsPerSecond(r);
+                        record.cpuMhz     = r.cpuMhz;
+                        logSink.appendResults(formatter.format(record));
+                    }
+
+                    abOps[k - 1u].push_back(otherOpsPerSec);
+
+                    buffer << "Engine " << other.name << " Ops/sec " << formatWithCommas(static_cast<n_type>(otherOpsPerSec))
+                           << " Iterations " << formatWithCommas(otherIterations) << "\n";
+                    itLines << "Engine\t" << other.name << "\t" << otherIterations << "\n";
+                }
+            }
+
+            // Show path to detail file, then the detail itself; progress shows one line instead
+            if(console.shows(Verbosity::full))
+            {
+                console.write(Verbosity::full, (detailLog ? detailLogPath.string() + " cycle " + std::to_string(cycle)
+                                                          : detailFilePath.string()) + "\n" + buffer.str());
+            }
+            else if(console.shows(Verbosity::progress))
+            {
+                console.write(Verbosity::progress, "Cycle " + std::to_string(cycle) + " of " + std::to_string(cycles)
+                              + (cpuMode ? ": " + formatWithCommas(static_cast<n_type>(cycleOps.back())) + " ops/sec\n" : " done\n"));
+            }
+
+            // Write buffer to detail file or binary log (in the background)
+            logSink.writeCycleDetail(cycle, detailFilePath, buffer.str());
+
+            // Append info to iteration log
+            {
+                std::ostringstream itLog;
+                itLog << "***\t" << cycle << "\t" << std::string(60, '*') << "\n";
+                itLog << startStr << "\n";
+                itLog << itLines.str();
+                itLog << endStr << "\n\n";
+                logSink.appendIteration(itLog.str());
+            }
+
+            // Confidence-interval mode: once the planned cycles are done, extend the run
+            // one cycle at a time until the 95% CI is tight enough or --max-cycles is hit
+            if(ciMode && cycle == cycles)
+            {
+                ciHalfWidth = relativeHalfWidth95(computeCycleStats(cycleOps));
+                converged = cycleOps.size() >= 3u && ciHalfWidth >= 0.0 && ciHalfWidth * 100.0 <= opts.ciTarget;
+
+                if(!converged && cycles < opts.maxCycles) ++cycles;
+            }
+
+            // Optional cool-down before the next cycle
+            if(opts.cooldownMs > 0u && cycle < cycles)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(opts.cooldownMs));
+            }
+        }
+
+        // 11) Final summary
+        const auto cycleEndTime = std::chrono::system_clock::now();
+        const std::chrono::duration<double> totalDiff = cycleEndTime - cycleStartTime;
+        const long long totalMs = std::chrono::duration_cast<std::chrono::milliseconds>(totalDiff).count();
+
+        const long long days    = totalMs / (1000LL * 60 * 60 * 24);
+        long long rem     = totalMs % (1000LL * 60 * 60 * 24);
+        const long long hours   = rem / (1000LL * 60 * 60);
+        rem              %= (1000LL * 60 * 60);
+        const long long minutes = rem / (1000LL * 60);
+        rem              %= (1000LL * 60);
+        const long long seconds = rem / 1000LL;
+        const long long ms      = rem % 1000LL;
+
+        // Memory mode: mean of every placement/size/test across cycles
+        std::ostringstream memTable;
+
+        if(memoryMode)
+        {
+            memTable << "Memory averages across " << cycles << " cycles (GB/s, latency in ns/access)\n"
+                     << "CPU node\tMemory node\tSize";
+
+            for(const char *test : memoryTests) memTable << "\t" << test;
+
+            memTable << "\n" << std::fixed;
+
+            for(const auto &entry : memSummary)
+            {
+                memTable << std::get<0>(entry.first) << "\t" << std::get<1>(entry.first) << "\t"
+                         << formatBytes(std::get<2>(entry.first));
+
+                for(unsigned test = 0u; test < memoryTestCount; ++test)
+                {
+                    const double mean = entry.second.count[test] ? entry.second.sum[test] / entry.second.count[test] : 0.0;
+                    memTable << "\t" << std::setprecision(test == memoryLatencyTest ? 2 : 3) << mean;
+                }
+
+                memTable << "\n";
+            }
+
+            console.write(Verbosity::summary, memTable.str() + "\n");
+        }
+
+        // Core-to-core mode: mean matrix across cycles, also written next to Iteration.txt
+        std::ostringstream c2cTable;
+
+        if(c2cMode)
+        {
+            std::vector<std::vector<double>> mean = c2cSum;
+
+            for(auto &row : mean)
+            {
+                for(double &value : row) value /= static_cast<double>(cycles);
+            }
+
+            c2cTable << "Core-to-core one-way latency across " << cycles << " cycles (ns, "
+                     << opts.c2cRoundTrips << " round trips per batch)\n" << renderLatencyMatrix(c2cCpus, mean);
+
+            console.write(Verbosity::summary, c2cTable.str() + "\n");
+
+            const fs::path matrixPath = iterationDir / ("CoreLatency " + getFileTimestamp() + ".txt");
+            logSink.writeDetail(matrixPath, c2cTable.str());
+
+            console.write(Verbosity::progress, matrixPath.string() + "\n\n");
+        }
+
+        if(cpuMode)
+        {
+            console.write(Verbosity::summary, "******\tSum: " + formatWithCommas(sumOfIterations)
+                          + " operations across " + formatWithCommas(cycles) + " cycles *********\n\n");
+        }
+
+        // Normalized by each window's measured length, so --duration-ms still reports per second
+        const n_type avgOpsPerSec = (cycles > 0) ? static_cast<n_type>(sumOfOpsPerSec / cycles) : 0;
+        if(cpuMode)
+        {
+            console.write(Verbosity::summary, "Average: " + formatWithCommas(avgOpsPerSec)
+                          + " operations per second **********\n\n");
+        }
+
+        const n_type avgPerThread = avgOpsPerSec / threadCount;
+
+        if(multiThreaded && cpuMode)
+        {
+            console.write(Verbosity::summary, "Per-thread average: " + formatWithCommas(avgPerThread)
+                          + " operations per second across " + std::to_string(threadCount) + " threads **********\n\n");
+        }
+
+        // Spread of the per-cycle figures: jitter, noisy neighbours and throttling show up here
+        const CycleStats stats = computeCycleStats(cycleOps);
+        std::ostringstream statsText;
+
+        if(cpuMode)
+        {
+            statsText << renderCycleStats(stats, cycleOps);
+
+            if(ciMode)
+            {
+                statsText << "Confidence target " << fixedText(opts.ciTarget, 2) << "% "
+                          << (converged ? "reached" : "not reached") << " after " << cycles << " cycles\n";
+            }
+
+            if(telemetry) statsText << "Across cycles: " << renderTelemetry(runTelemetry) << "\n";
+
+            if(runThrottle.valid)
+            {
+                statsText << renderCgroupThrottle(runThrottle) << " over the run, in " << throttledCycles << " of " << cycles << " cycles\n";
+            }
+
+            if(workerNs > 0u)
+            {
+                statsText << "Harness overhead: " << fixedText(100.0 * harnessNs / static_cast<double>(workerNs), 4)
+                          << "% of the measurement window (deadline checks and progress samples)\n";
+            }
+
+            if(cgroup.quotaCpus > 0.0)
+            {
+                statsText << "Per quota CPU: " << formatWithCommas(static_cast<n_type>(sumOfOpsPerSec / cycles / cgroup.quotaCpus))
+                          << " operations per second (quota " << fixedText(cgroup.quotaCpus, 2) << " CPUs)\n";
+            }
+            if(profileMode) statsText << renderWorkloadSummary(profile, workloadOps, soloOps);
+        }
+
+        // A/B: every other engine's per-cycle ops/sec against the selected one (Welch's t-test)
+        std::vector<CycleStats> abStats;
+        std::vector<EngineComparison> abComparisons;
+
+        abStats.reserve(abEngines.size());
+
+        if(abMode)
+        {
+            statsText << "A/B timing engines across " << cycles << " cycles, relative to " << engine->name << "\n"
+                      << "Engine\tMean ops/sec\tCV\tDelta\t95% CI\tt\tdf\tSignificant\n"
+                      << engine->name << "\t" << fixedText(stats.mean, 0) << "\t" << fixedText(stats.cv * 100.0, 2)
+                      << "%\t-\t-\t-\t-\t-\n";
+
+            for(std::size_t k = 0u; k < abEngines.size(); ++k)
+            {
+                abStats.push_back(computeCycleStats(abOps[k]));
+                abComparisons.push_back(welchCompare(stats, abStats[k]));
+
+                const EngineComparison &c = abComparisons[k];
+
+                statsText << abEngines[k]->name << "\t" << fixedText(abStats[k].mean, 0) << "\t"
+                          << fixedText(abStats[k].cv * 100.0, 2) << "%\t";
+
+                if(c.valid)
+                {
+                    statsText << (c.delta >= 0.0 ? "+" : "") << fixedText(c.delta * 100.0, 2) << "%\t+/- "
+                              << fixedText(c.halfWidth * 100.0, 2) << "%\t" << fixedText(c.t, 2) << "\t"
+                              << fixedText(c.df, 1) << "\t" << (c.significant ? "yes" : "no") << "\n";
+                }
+                else
+                {
+                    statsText << "n/a (needs 2+ cycles)\n";
+                }
+            }
+        }
+
+        // Baseline: this run against the host's stored runs, then stored itself, unless
+        // it was flagged as a regression (so a slowed host cannot drag its baseline down)
+        EngineComparison baselineResult;
+        const char *verdict = "";
+
+        if(cpuMode)
+        {
+            BaselineEntry entry = BaselineDb::makeEntry(baselineHost, cpuModel, kernelLabel, engine->name, threadCount,
+                                                        opts.durationMs, opts.warmupMs);
+            entry.timeNs = epochNs(cycleEndTime);
+            entry.cycles = static_cast<std::uint32_t>(cycles);
+            entry.mean   = stats.mean;
+            entry.median = stats.median;
+            entry.stddev = stats.stddev;
+            entry.min    = stats.min;
+            entry.max    = stats.max;
+
+            if(opts.compareBaseline)
+            {
+                const std::vector<BaselineEntry> history = baselineDb.lookup(entry, baselineHistory);
+                baselineResult = baselineCompare(history, stats.mean);
+
+                const EngineComparison &c = baselineResult;
+                verdict = !c.valid ? "insufficient" : !c.significant ? "ok" : (c.delta < 0.0) ? "regression" : "improvement";
+                regressed = regressed || (c.significant && c.delta < 0.0);
+
+                statsText << "Baseline: " << history.size() << " prior run(s) of " << kernelLabel << " on " << engine->name
+                          << " with " << formatWindow(opts.durationMs) << " windows, "
+                          << (opts.warmupMs ? formatWindow(opts.warmupMs) + " warmup" : std::string("no warmup")) << ", "
+                          << threadCount << " thread(s) on " << cpuModel;
+
+                if(c.valid)
+                {
+                    statsText << ", mean " << formatWithCommas(static_cast<n_type>(stats.mean / (1.0 + c.delta)))
+                              << " ops/sec\nBaseline delta " << (c.delta >= 0.0 ? "+" : "") << fixedText(c.delta * 100.0, 2)
+                              << "% (95% prediction interval +/- " << fixedText(c.halfWidth * 100.0, 2) << "%): " << verdict << "\n";
+                }
+                else
+                {
+                    statsText << "; 2+ needed to compare\n";
+                }
+
+                if(!baselineDb.error().empty()) std::cerr << "Warning: " << baselineDb.error() << "\n";
+            }
+
+            if(std::strcmp(verdict, "regression") != 0 && !baselineDb.append(entry))
+            {
+                std::cerr << "Warning: run not stored in baseline history"
+                          << (baselineDb.error().empty() ? "" : ": " + baselineDb.error()) << "\n";
+            }
+        }
+
+        if(cpuMode)
+        {
+            console.write(Verbosity::summary, statsText.str() + "\n");
+        }
+
+        const auto cycleStartStr = dateTimeToString(cycleStartTime);
+        const auto cycleEndStr   = dateTimeToString(cycleEndTime);
+
+        {
+            std::ostringstream timing;
+            timing << "Cycle started: " << cycleStartStr
+                   << " ... Cycle ended: " << cycleEndStr
+                   << " **********\n";
+            timing << "Time: " << days << " days " << hours << " hrs "
+                   << minutes << " min " << seconds << " sec "
+                   << ms << " ms\n";
+            console.write(Verbosity::summary, timing.str());
+        }
+
+        // Write final summary to iteration log
+        {
+            std::ostringstream itLog;
+            if(memoryMode)
+            {
+                itLog << memTable.str();
+            }
+            else if(c2cMode)
+            {
+                itLog << c2cTable.str();
+            }
+            else
+            {
+                itLog << "******\tSum: " << sumToString(sumOfIterations)
+                      << " operations across " << cycles << " cycles *********\n";
+            }
+
+            itLog << "Cycle started: " << cycleStartStr
+                  << " ... Cycle ended: " << cycleEndStr << " **********\n";
+
+            if(cpuMode)
+            {
+                itLog << "Average: " << avgOpsPerSec
+                      << " operations per second **********\n";
+            }
+
+            if(multiThreaded && cpuMode)
+            {
+                itLog << "Per-thread average: " << avgPerThread
+                      << " operations per second across " << threadCount << " threads **********\n";
+            }
+
+            itLog << statsText.str();
+
+            itLog << "Time: " << days << " days " << hours << " hrs "
+                  << minutes << " min " << seconds << " sec "
+                  << ms << " ms\n";
+            itLog << std::string(33, '_') << "\n\n";
+            logSink.appendIteration(itLog.str());
+        }
+
+        if(writeResults)
+        {
+            ResultRecord record;
+            record.record     = "summary";
+            record.cycle      = cycles;
+            record.kernel     = cpuMode ? kernel->name : "";
+            record.engine     = cpuMode ? engine->name : "";
+            record.threads    = cpuMode ? threadCount : 0u;
+            record.startNs    = epochNs(cycleStartTime);
+            record.endNs      = epochNs(cycleEndTime);
+            record.iterations = sumOfIterations;
+            record.opsPerSec  = cpuMode ? sumOfOpsPerSec / cycles : 0.0;
+            record.stats      = cpuMode ? &stats : nullptr;
+            record.ciHalfWidth = relativeHalfWidth95(stats);
+            record.telemetry  = telemetry ? &runTelemetry : nullptr;
+            record.cgroup     = cpuMode ? &runThrottle : nullptr;
+            logSink.appendResults(formatter.format(record));
+
+            // One record per profile workload; value is the change against its solo run
+            for(std::size_t k = 0u; k < workloadOps.size(); ++k)
+            {
+                const CycleStats workloadStats = computeCycleStats(workloadOps[k]);
+
+                ResultRecord workload;
+                workload.record    = "workload-summary";
+                workload.cycle     = cycles;
+                workload.threads   = profile.workloads[k].threads;
+                workload.kernel    = profile.workloads[k].kernel->name;
+                workload.engine    = engine->name;
+                workload.opsPerSec = workloadStats.mean;
+                workload.stats     = &workloadStats;
+                workload.ciHalfWidth = relativeHalfWidth95(workloadStats);
+                workload.workload  = profile.workloads[k].name;
+
+                if(k < soloOps.size() && soloOps[k] > 0.0)
+                {
+                    workload.value = workloadStats.mean / soloOps[k] - 1.0;
+                    workload.unit  = "relative to solo";
+                }
+
+                logSink.appendResults(formatter.format(workload));
+            }
+
+            // One comparison record per A/B engine; value is the relative delta, ci95 its half-width
+            for(std::size_t k = 0u; k < abEngines.size(); ++k)
+            {
+                ResultRecord comparison;
+                comparison.record      = "comparison";
+                comparison.cycle       = cycles;
+                comparison.threads     = threadCount;
+                comparison.kernel      = kernel->name;
+                comparison.engine      = abEngines[k]->name;
+                comparison.opsPerSec   = abStats[k].mean;
+                comparison.stats       = &abStats[k];
+                comparison.value       = abComparisons[k].delta;
+                comparison.unit        = "relative";
+                comparison.ciHalfWidth = abComparisons[k].halfWidth;
+                logSink.appendResults(formatter.format(comparison));
+            }
+
+            // value is the delta against the stored runs, ci95 the prediction half-width
+            if(opts.compareBaseline)
+            {
+                ResultRecord baseline;
+                baseline.record      = "baseline";
+                baseline.cycle       = cycles;
+                baseline.threads     = threadCount;
+                baseline.kernel      = kernelLabel;
+                baseline.engine      = engine->name;
+                baseline.opsPerSec   = stats.mean;
+                baseline.value       = baselineResult.delta;
+                baseline.unit        = "relative";
+                baseline.ciHalfWidth = baselineResult.halfWidth;
+                baseline.verdict     = verdict;
+                logSink.appendResults(formatter.format(baseline));
+            }
+        }
+
+        ScalingPoint point;
+        point.threads = threadCount;
+        point.opsPerSec = sumOfOpsPerSec / cycles;
+        point.cv = stats.cv;
+        scaling.push_back(point);
+    }
+
+    // 12) Sweep: speedup and efficiency per thread count, after the last summary
+    if(sweepMode)
+    {
+        computeScaling(scaling);
+
+        const std::string table = renderScalingTable(scaling);
+        console.write(Verbosity::summary, "\n" + table + "\n");
+        logSink.appendIteration(table + std::string(33, '_') + "\n\n");
+
+        for(const ScalingPoint &point : scaling)
+        {
+            if(!writeResults) break;
+
+            ResultRecord record;
+            record.record     = "scaling";
+            record.threads    = point.threads;
+            record.kernel     = kernel->name;
+            record.engine     = engine->name;
+            record.opsPerSec  = point.opsPerSec;
+            record.speedup    = point.speedup;
+            record.efficiency = point.efficiency;
+            logSink.appendResults(formatter.format(record));
+        }
+    }
+
+    if(writeResults) logSink.appendResults(formatter.footer());
+
+    // Host admission gates can key off the exit status
+    return regressed ? 2 : 0;
 }
 